@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Compares the propagation policies on the given programs:
+# ./propagation-benchmark.sh [symex options] file.c ...
+
+symex=$(dirname "$0")/../src/symex/symex
+
+options=()
+files=()
+
+for arg in "$@" ; do
+  case $arg in
+    *.c|*.gb) files+=("$arg") ;;
+    *) options+=("$arg") ;;
+  esac
+done
+
+printf "%-30s %-10s %10s %10s %10s %12s\n" \
+  file propagation variables clauses VCCs solver
+for file in "${files[@]}" ; do
+  for propagation in none simple aggressive ; do
+    output=$($symex "${options[@]}" --propagation $propagation "$file" 2>&1)
+    variables=$(echo "$output" | sed -n 's/^Formula size: \([0-9]*\) variables.*/\1/p')
+    clauses=$(echo "$output" | sed -n 's/^Formula size: .* \([0-9]*\) clauses/\1/p')
+    vccs=$(echo "$output" | sed -n 's/^Generated \([0-9]*\) VCC.*/\1/p')
+    solver=$(echo "$output" | sed -n 's/^Runtime decision procedure: //p')
+    printf "%-30s %-10s %10s %10s %10s %12s\n" \
+      "$file" $propagation "$variables" "$clauses" "$vccs" "$solver"
+  done
+done
@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Compares the time spent in reads with and without --fused-read
+# on the regression inputs, or on the given programs:
+# ./read-benchmark.sh [file.c ...]
+
+symex=$(dirname "$0")/../src/symex/symex
+
+if [ $# -eq 0 ] ; then
+  set -- $(dirname "$0")/symex/*/main.c
+fi
+
+printf "%-50s %12s %12s\n" file separate fused
+for file in "$@" ; do
+  separate=$($symex "$file" 2>&1 | sed -n 's/^Runtime read: //p')
+  fused=$($symex --fused-read "$file" 2>&1 | sed -n 's/^Runtime read (fused): //p')
+  printf "%-50s %12s %12s\n" "$file" "$separate" "$fused"
+done
@@ -0,0 +1,20 @@
+#include <assert.h>
+
+int table[1000];
+
+unsigned nondet_unsigned();
+
+int main()
+{
+  unsigned i=nondet_unsigned();
+  __CPROVER_assume(i<1000);
+
+  table[i]=42;
+  table[3]=1;
+
+  if(i!=3)
+    assert(table[i]==42);
+
+  assert(table[3]==1);
+  assert(table[4]==0 || i==4);
+}
@@ -0,0 +1,12 @@
+int main()
+{
+  int x;
+
+  // every iteration after the first ends in the same state
+  while(x!=1)
+    x=0;
+
+  __CPROVER_assert(x==1, "exit");
+
+  return 0;
+}
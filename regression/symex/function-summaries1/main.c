@@ -0,0 +1,30 @@
+int table[4]={ 1, 2, 3, 4 };
+int calls;
+
+int sum(int n)
+{
+  int s=0;
+  for(int i=0; i<n; i++)
+    s+=table[i];
+  calls++;
+  return s;
+}
+
+int main()
+{
+  int x, y;
+
+  if(x)
+    y=sum(4);
+  else
+    y=sum(3)+4;
+
+  // the same calls on both paths
+  int z=sum(4)+sum(4);
+
+  __CPROVER_assert(y==10, "sum");
+  __CPROVER_assert(z==20, "sum twice");
+  __CPROVER_assert(calls==3, "calls");
+
+  return 0;
+}
@@ -0,0 +1,23 @@
+#include <assert.h>
+
+struct point
+{
+  int x, y;
+};
+
+int nondet_int();
+
+int main()
+{
+  struct point p={ 1, 2 };
+  struct point *q=&p;
+  int z=nondet_int();
+
+  q->x=q->y+(z-z);
+  assert(p.x==2);
+
+  if(z>0)
+    q->y=z;
+
+  assert(p.y>=2 || p.y==z);
+}
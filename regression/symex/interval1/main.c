@@ -0,0 +1,22 @@
+#include <assert.h>
+
+unsigned nondet_unsigned();
+
+int main()
+{
+  unsigned x=nondet_unsigned();
+  __CPROVER_assume(x<100);
+
+  unsigned y=x+1;
+
+  if(y>200)
+    assert(0);
+
+  if(x>=50)
+  {
+    if(y<51)
+      assert(0);
+  }
+
+  assert(y<=100);
+}
@@ -0,0 +1,32 @@
+int nondet_int();
+
+int twice(int a)
+{
+  int r=a+a;
+  return r;
+}
+
+int main()
+{
+  int x, t, u;
+
+  // t is dead at the loop head; its fresh value would
+  // otherwise tell the iterations apart
+  while(x!=1)
+  {
+    t=nondet_int();
+    x=0;
+  }
+
+  if(x>0)
+    t=1;
+  else
+    t=2;
+
+  // t is live until here
+  u=twice(t);
+  __CPROVER_assert(u==2 || u==4, "twice");
+  __CPROVER_assert(x==1, "exit");
+
+  return 0;
+}
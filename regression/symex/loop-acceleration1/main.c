@@ -0,0 +1,25 @@
+#include <assert.h>
+
+unsigned nondet_unsigned();
+
+int main()
+{
+  unsigned n=1;
+  unsigned sum=0;
+
+  while(n<=40000)
+  {
+    sum=sum+n;
+    n=n+1;
+  }
+
+  assert(sum==800020000);
+
+  unsigned x=nondet_unsigned();
+  unsigned y=x;
+
+  for(int i=10; i>0; i--)
+    y=y+3;
+
+  assert(y==x+30);
+}
@@ -0,0 +1,14 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int sum=0;
+
+  for(int i=0; i<5; i++)
+    if(nondet_int())
+      sum++;
+
+  assert(sum<=5);
+}
@@ -0,0 +1,15 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int sum=0;
+
+  // far too many paths to explore them all
+  for(int i=0; i<40; i++)
+    if(nondet_int())
+      sum++;
+
+  assert(sum<=40);
+}
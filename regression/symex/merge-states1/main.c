@@ -0,0 +1,24 @@
+#include <assert.h>
+
+int main()
+{
+  int x;
+  int p1=0, p2=0;
+  int y;
+
+  for(int i=0; i<8; i++)
+  {
+    if(x)
+      p1=p1+1;
+    else
+      p2=p2+1;
+  }
+
+  if(x)
+    y=1;
+  else
+    y=2;
+
+  assert(y==1 || y==2);
+  assert(p1+p2==8);
+}
@@ -0,0 +1,16 @@
+#include <assert.h>
+
+int input();
+
+int main()
+{
+  int x=input();
+  int y;
+
+  if(x>10)
+    y=1;
+  else
+    y=2;
+
+  assert(y!=2 || x!=3);
+}
@@ -0,0 +1,17 @@
+#include <assert.h>
+
+int a;
+int *ptrs[100];
+
+unsigned nondet_unsigned();
+
+int main()
+{
+  unsigned i=nondet_unsigned();
+  __CPROVER_assume(i<100);
+  ptrs[i]=&a;
+
+  int *p=ptrs[i];
+  *p=1;
+  assert(a==1);
+}
@@ -0,0 +1,19 @@
+#include <assert.h>
+
+int a;
+int *ptrs[100];
+
+unsigned nondet_unsigned();
+
+int main()
+{
+  unsigned i=nondet_unsigned();
+  unsigned j=nondet_unsigned();
+  __CPROVER_assume(i<100 && j<100 && i!=j);
+  ptrs[i]=&a;
+
+  // this is NULL, and the store does not reach a
+  int *p=ptrs[j];
+  *p=1;
+  assert(a==1);
+}
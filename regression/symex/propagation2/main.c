@@ -0,0 +1,17 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int x=nondet_int();
+
+  // propagated unless propagation is disabled
+  int z=5;
+
+  // propagated only when propagating aggressively
+  int y=x*2;
+
+  assert(z==5);
+  assert(y==x*2);
+}
@@ -0,0 +1,37 @@
+struct inner
+{
+  int a[3];
+  char c;
+};
+
+struct S
+{
+  int x;
+  struct inner i;
+};
+
+int nondet_int();
+
+int main()
+{
+  struct S s1, s2, s3;
+  struct S *p=&s2;
+
+  s1.x=nondet_int();
+  s1.i.a[1]=nondet_int();
+  s1.i.c='c';
+
+  s2=s1;
+  s3=*p;
+  s2.x++;
+
+  __CPROVER_assert(s2.x==s1.x+1, "the copy is written separately");
+  __CPROVER_assert(s3.x==s1.x, "the source is unchanged");
+  __CPROVER_assert(s3.i.a[1]==s1.i.a[1], "nested components are copied");
+  __CPROVER_assert(s3.i.c=='c', "values are copied");
+
+  s1.i=s3.i;
+  __CPROVER_assert(s1.i.a[0]==s2.i.a[0], "uninitialised components agree");
+
+  return 0;
+}
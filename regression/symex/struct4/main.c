@@ -0,0 +1,24 @@
+#include <assert.h>
+
+struct S
+{
+  int x;
+  int big[100];
+};
+
+struct S s1, s2;
+
+_Bool nondet_bool();
+
+int main()
+{
+  struct S *p=nondet_bool()?&s1:&s2;
+
+  p->x=1;
+  p->big[50]=2;
+
+  assert(p->x==1);
+  assert(s1.x==1 || s2.x==1);
+  assert(p->big[50]==2);
+  assert(s1.big[49]==0 && s2.big[51]==0);
+}
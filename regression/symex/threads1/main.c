@@ -0,0 +1,17 @@
+int x;
+
+void worker()
+{
+  x=1;
+}
+
+int main()
+{
+  __CPROVER_ASYNC_1: worker();
+
+  // the worker may or may not have run
+  int y=x;
+  __CPROVER_assert(y==0, "worker has not run");
+
+  return 0;
+}
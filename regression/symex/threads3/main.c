@@ -0,0 +1,22 @@
+int x, y;
+
+void worker1()
+{
+  x=1;
+}
+
+void worker2()
+{
+  y=1;
+}
+
+int main()
+{
+  __CPROVER_ASYNC_1: worker1();
+  __CPROVER_ASYNC_2: worker2();
+
+  // the order of the two writes does not matter
+  __CPROVER_assert(x<=1 && y<=1, "bounded");
+
+  return 0;
+}
@@ -0,0 +1,17 @@
+int main()
+{
+  int x, y;
+
+  if(x)
+    y=1;
+  else
+    y=2;
+
+  __CPROVER_assert(y!=1, "one");
+
+  // no assertion left once the one above has failed
+  for(int i=0; i<100; i++)
+    y++;
+
+  return 0;
+}
@@ -0,0 +1,14 @@
+#include <assert.h>
+
+int main()
+{
+  int s=0;
+
+  for(int i=0; i<3; i++)
+    s++;
+
+  for(int j=0; j<20; j++)
+    s++;
+
+  assert(s==23);
+}
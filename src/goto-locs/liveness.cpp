@@ -0,0 +1,280 @@
+/*******************************************************************\
+
+Module: Liveness of Local Variables for locs
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Liveness of Local Variables for locs
+
+#include "liveness.h"
+
+#include <set>
+#include <unordered_map>
+
+#include <util/symbol.h>
+
+/// adds the identifiers of the symbols in \p src to \p dest,
+/// including those in the sizes of array types
+static void get_symbols(const exprt &src, std::set<irep_idt> &dest)
+{
+  if(src.id()==ID_symbol)
+    dest.insert(to_symbol_expr(src).get_identifier());
+
+  for(const typet *t=&src.type(); t->id()==ID_array; t=&t->subtype())
+    get_symbols(to_array_type(*t).size(), dest);
+
+  forall_operands(it, src)
+    get_symbols(*it, dest);
+}
+
+static void get_address_taken(const exprt &src, std::set<irep_idt> &dest)
+{
+  if(src.id()==ID_address_of)
+    get_symbols(src, dest);
+  else
+  {
+    forall_operands(it, src)
+      get_address_taken(*it, dest);
+  }
+}
+
+/// a complete assignment to a symbol defines it, and
+/// any other assignment reads the symbols in the lhs
+static void get_lhs(
+  const exprt &lhs,
+  std::set<irep_idt> &uses,
+  std::set<irep_idt> &defs)
+{
+  if(lhs.id()==ID_symbol)
+    defs.insert(to_symbol_expr(lhs).get_identifier());
+  else
+    get_symbols(lhs, uses);
+}
+
+void livenesst::build(const locst &locs, const namespacet &ns)
+{
+  on_entry.clear();
+  on_return.clear();
+  on_entry.resize(locs.size());
+  on_return.resize(locs.size());
+
+  // the functions are stored consecutively
+  for(const auto &f : locs.function_map)
+  {
+    const loc_reft first=f.second.first_loc;
+
+    if(first.is_nil())
+      continue;
+
+    std::size_t end=first.loc_number;
+    while(end<locs.size() &&
+          locs.loc_vector[end].function_identifier==f.first)
+      end++;
+
+    build_function(locs, ns, f.first, first.loc_number, end);
+  }
+}
+
+void livenesst::build_function(
+  const locst &locs,
+  const namespacet &ns,
+  const irep_idt &function,
+  std::size_t begin,
+  std::size_t end)
+{
+  if(end==begin || locs.loc_vector[end-1].type!=END_FUNCTION)
+    return;
+
+  const std::size_t size=end-begin;
+  const std::size_t exit=size-1;
+
+  // the symbols read and defined, relative to begin
+  std::vector<std::set<irep_idt>> uses(size), defs(size);
+  std::set<irep_idt> address_taken;
+
+  for(std::size_t l=0; l<size; l++)
+  {
+    const loct &loc=locs.loc_vector[begin+l];
+    const goto_programt::instructiont &instruction=*loc.target;
+
+    get_address_taken(instruction.code, address_taken);
+    get_address_taken(instruction.guard, address_taken);
+
+    switch(loc.type)
+    {
+    case ASSIGN:
+      {
+        const code_assignt &code_assign=to_code_assign(instruction.code);
+        get_lhs(code_assign.lhs(), uses[l], defs[l]);
+        get_symbols(code_assign.rhs(), uses[l]);
+      }
+      break;
+
+    case FUNCTION_CALL:
+      {
+        const code_function_callt &call=
+          to_code_function_call(instruction.code);
+        if(call.lhs().is_not_nil())
+          get_lhs(call.lhs(), uses[l], defs[l]);
+        get_symbols(call.function(), uses[l]);
+        for(const auto &argument : call.arguments())
+          get_symbols(argument, uses[l]);
+      }
+      break;
+
+    case DECL:
+      defs[l].insert(instruction.get_decl().symbol().get_identifier());
+      break;
+
+    case DEAD:
+      defs[l].insert(instruction.get_dead().symbol().get_identifier());
+      break;
+
+    case RETURN:
+      // the value is only read on return
+      get_symbols(instruction.code, uses[exit]);
+      break;
+
+    default:
+      get_symbols(instruction.code, uses[l]);
+      get_symbols(instruction.guard, uses[l]);
+    }
+  }
+
+  // the local variables, numbered
+  std::unordered_map<irep_idt, std::size_t, irep_id_hash> numbers;
+  variablest variables;
+
+  auto add=[&](const irep_idt &identifier)
+  {
+    const symbolt *symbol;
+    if(address_taken.find(identifier)!=address_taken.end() ||
+       numbers.find(identifier)!=numbers.end() ||
+       ns.lookup(identifier, symbol) ||
+       symbol->is_static_lifetime ||
+       symbol->type.id()==ID_code)
+      return;
+
+    numbers[identifier]=variables.size();
+    variables.push_back(identifier);
+  };
+
+  const locst::function_entryt &function_entry=
+    locs.function_map.find(function)->second;
+
+  for(const auto &parameter : function_entry.type.parameters())
+    add(parameter.get_identifier());
+
+  const std::size_t no_parameters=variables.size();
+
+  for(std::size_t l=0; l<size; l++)
+  {
+    for(const auto &identifier : uses[l])
+      add(identifier);
+    for(const auto &identifier : defs[l])
+      add(identifier);
+  }
+
+  if(variables.empty())
+    return;
+
+  typedef std::vector<bool> sett;
+  const std::size_t no_variables=variables.size();
+
+  auto to_set=[&](const std::set<irep_idt> &src)
+  {
+    sett result(no_variables, false);
+    for(const auto &identifier : src)
+    {
+      const auto it=numbers.find(identifier);
+      if(it!=numbers.end())
+        result[it->second]=true;
+    }
+    return result;
+  };
+
+  std::vector<sett> use_sets, def_sets;
+  use_sets.reserve(size);
+  def_sets.reserve(size);
+
+  for(std::size_t l=0; l<size; l++)
+  {
+    use_sets.push_back(to_set(uses[l]));
+    def_sets.push_back(to_set(defs[l]));
+  }
+
+  // the successors, relative to begin
+  std::vector<std::vector<std::size_t>> successors(size);
+
+  for(std::size_t l=0; l<size; l++)
+  {
+    const loct &loc=locs.loc_vector[begin+l];
+
+    if(loc.type==END_FUNCTION || loc.type==END_THREAD)
+      continue;
+
+    if((loc.type==GOTO || loc.type==START_THREAD) &&
+       loc.branch_target.loc_number>=begin &&
+       loc.branch_target.loc_number<end)
+    {
+      successors[l].push_back(loc.branch_target.loc_number-begin);
+
+      if(loc.type==GOTO && loc.target->get_condition().is_true())
+        continue;
+    }
+
+    if(l+1<size)
+      successors[l].push_back(l+1);
+  }
+
+  // live_in=uses+(live_out-defs), backwards until nothing changes
+  std::vector<sett> live_in(size, sett(no_variables, false));
+
+  bool changed=true;
+
+  while(changed)
+  {
+    changed=false;
+
+    for(std::size_t l=size; l-->0;)
+    {
+      sett live=use_sets[l];
+
+      for(const auto s : successors[l])
+        for(std::size_t v=0; v<no_variables; v++)
+          if(live_in[s][v] && !def_sets[l][v])
+            live[v]=true;
+
+      if(live!=live_in[l])
+      {
+        live_in[l].swap(live);
+        changed=true;
+      }
+    }
+  }
+
+  // the variables that may be live at a predecessor, or be defined
+  // there, and the parameters at the entry
+  std::vector<sett> before(size, sett(no_variables, false));
+
+  for(std::size_t v=0; v<no_parameters; v++)
+    before[0][v]=true;
+
+  for(std::size_t l=0; l<size; l++)
+    for(const auto s : successors[l])
+      for(std::size_t v=0; v<no_variables; v++)
+        if(live_in[l][v] || def_sets[l][v])
+          before[s][v]=true;
+
+  for(std::size_t l=0; l<size; l++)
+    for(std::size_t v=0; v<no_variables; v++)
+      if(before[l][v] && !live_in[l][v])
+        on_entry[begin+l].push_back(variables[v]);
+
+  for(std::size_t v=0; v<no_variables; v++)
+    if(use_sets[exit][v])
+      on_return[begin+exit].push_back(variables[v]);
+}
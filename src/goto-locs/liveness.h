@@ -0,0 +1,63 @@
+/*******************************************************************\
+
+Module: Liveness of Local Variables for locs
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Liveness of Local Variables for locs
+
+#ifndef CPROVER_GOTO_LOCS_LIVENESS_H
+#define CPROVER_GOTO_LOCS_LIVENESS_H
+
+#include <vector>
+
+#include "locs.h"
+
+#include <util/invariant.h>
+#include <util/namespace.h>
+
+/// The local variables of each function that die on the way into
+/// the locations, computed separately for each function. Variables
+/// whose address is taken are never considered dead, and the value
+/// of a RETURN is taken to be read at the END_FUNCTION.
+class livenesst
+{
+public:
+  void build(const locst &, const namespacet &);
+
+  typedef std::vector<irep_idt> variablest;
+
+  /// \return the variables that are dead at the location,
+  ///   but may be live at one of its predecessors
+  const variablest &dead_on_entry(const loc_reft loc_ref) const
+  {
+    PRECONDITION(!loc_ref.is_nil());
+    DATA_INVARIANT(loc_ref.loc_number<on_entry.size(), "loc_ref ok");
+    return on_entry[loc_ref.loc_number];
+  }
+
+  /// \return for an END_FUNCTION, the variables that
+  ///   are dead once the return value has been assigned
+  const variablest &dead_on_return(const loc_reft loc_ref) const
+  {
+    PRECONDITION(!loc_ref.is_nil());
+    DATA_INVARIANT(loc_ref.loc_number<on_return.size(), "loc_ref ok");
+    return on_return[loc_ref.loc_number];
+  }
+
+protected:
+  // by loc_reft::loc_number
+  std::vector<variablest> on_entry, on_return;
+
+  void build_function(
+    const locst &,
+    const namespacet &,
+    const irep_idt &function,
+    std::size_t begin,
+    std::size_t end);
+};
+
+#endif // CPROVER_GOTO_LOCS_LIVENESS_H
@@ -9,6 +9,8 @@ Author: Daniel Kroening, kroening@kroening.com
 /// \file
 /// Program Locations
 
+#include <util/cprover_prefix.h>
+
 #include <langapi/language_util.h>
 
 #include "locs.h"
@@ -19,7 +21,7 @@ locst::locst(
 {
 }
 
-loc_reft locst::first_loc(const irep_idt &function_id)
+loc_reft locst::first_loc(const irep_idt &function_id) const
 {
   const auto f_it = function_map.find(function_id);
 
@@ -29,6 +31,38 @@ loc_reft locst::first_loc(const irep_idt &function_id)
     return f_it->second.first_loc;
 }
 
+void locst::annotate(loct &loc, bool hidden_function)
+{
+  const goto_programt::instructiont &i=*loc.target;
+
+  // we hide if the function is hidden or the instruction is hidden,
+  // and we also hide calls to __CPROVER_initialize
+  loc.hidden=
+    hidden_function ||
+    i.source_location.get_hide() ||
+    (i.is_function_call() &&
+     i.get_function_call().function().id()==ID_symbol &&
+     to_symbol_expr(i.get_function_call().function()).get_identifier()==
+       CPROVER_PREFIX "initialize");
+
+  if(i.is_backwards_goto())
+  {
+    loc.backwards_goto=true;
+    loc.loop_id=goto_programt::loop_id(loc.function_identifier, i);
+    loc.loop_index=loop_ids.size();
+    loop_ids.push_back(loc.loop_id);
+  }
+
+  if(i.is_assert())
+  {
+    const irep_idt &property_id=i.source_location.get_property_id();
+    auto entry=property_index_map.emplace(property_id, property_ids.size());
+    if(entry.second)
+      property_ids.push_back(property_id);
+    loc.property_index=entry.first->second;
+  }
+}
+
 void locst::build(const goto_functionst &goto_functions)
 {
   // build locations
@@ -54,7 +88,8 @@ void locst::build(const goto_functionst &goto_functions)
       forall_goto_program_instructions(i_it, goto_function.body)
       {
         target_map[i_it]=end();
-        loc_vector.push_back(loct(i_it));
+        loc_vector.push_back(loct(i_it, f_it->first));
+        annotate(loc_vector.back(), function_entry.hidden);
       }
     }
     else
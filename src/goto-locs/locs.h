@@ -12,6 +12,8 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_PATH_SYMEX_LOCS_H
 #define CPROVER_PATH_SYMEX_LOCS_H
 
+#include <limits>
+
 #include <util/std_expr.h>
 
 #include <goto-programs/goto_functions.h>
@@ -21,15 +23,49 @@ Author: Daniel Kroening, kroening@kroening.com
 struct loct
 {
 public:
-  explicit loct(goto_programt::const_targett _target):
-    target(_target)
+  loct(
+    goto_programt::const_targett _target,
+    const irep_idt &_function_identifier):
+    target(_target),
+    function_identifier(_function_identifier),
+    type(_target->type),
+    hidden(false),
+    backwards_goto(false),
+    loop_index(no_loop),
+    property_index(no_property)
   {
   }
 
   goto_programt::const_targett target;
+  irep_idt function_identifier;
 
   // we only support a single branch target
   loc_reft branch_target;
+
+  // The following is precomputed by locst::build
+  // from the instruction, to save the interpreter
+  // from re-deriving it on every step.
+
+  goto_program_instruction_typet type;
+
+  // the step is hidden in traces
+  bool hidden;
+
+  // for backwards GOTOs only
+  bool backwards_goto;
+  irep_idt loop_id;
+
+  // for backwards GOTOs only, index into locst::loop_ids
+  std::size_t loop_index;
+
+  // for assertions only, index into locst::property_ids
+  std::size_t property_index;
+
+  static const std::size_t no_loop=
+    std::numeric_limits<std::size_t>::max();
+
+  static const std::size_t no_property=
+    std::numeric_limits<std::size_t>::max();
 };
 
 class locst
@@ -50,7 +86,13 @@ public:
   typedef std::map<irep_idt, function_entryt> function_mapt;
   function_mapt function_map;
 
-  loc_reft first_loc(const irep_idt &function_id);
+  loc_reft first_loc(const irep_idt &function_id) const;
+
+  // the identifiers of the loops, one per backwards GOTO
+  std::vector<irep_idt> loop_ids;
+
+  // the distinct property identifiers of the assertions
+  std::vector<irep_idt> property_ids;
 
   explicit locst(const namespacet &_ns);
   void build(const goto_functionst &goto_functions);
@@ -85,6 +127,10 @@ public:
 
 protected:
   const namespacet &ns;
+
+  std::map<irep_idt, std::size_t> property_index_map;
+
+  void annotate(loct &, bool hidden_function);
 };
 
 class target_to_loc_mapt
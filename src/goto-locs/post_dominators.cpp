@@ -0,0 +1,164 @@
+/*******************************************************************\
+
+Module: Post-Dominators for locs
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Post-Dominators for locs
+
+#include "post_dominators.h"
+
+post_dominatorst::post_dominatorst(const locst &locs)
+{
+  map.resize(locs.size(), loc_reft::nil());
+
+  // the functions are stored consecutively
+  for(const auto &f : locs.function_map)
+  {
+    const loc_reft first=f.second.first_loc;
+
+    if(first.is_nil())
+      continue;
+
+    std::size_t end=first.loc_number;
+    while(end<locs.size() &&
+          locs.loc_vector[end].function_identifier==f.first)
+      end++;
+
+    build(locs, first.loc_number, end);
+  }
+}
+
+/// The algorithm by Cooper, Harvey and Kennedy, run on the
+/// reversed CFG of the locations in [begin, end), which end
+/// with the END_FUNCTION of the function.
+void post_dominatorst::build(
+  const locst &locs,
+  std::size_t begin,
+  std::size_t end)
+{
+  if(end==begin || locs.loc_vector[end-1].type!=END_FUNCTION)
+    return;
+
+  const std::size_t size=end-begin;
+  const std::size_t exit=size-1;
+  const std::size_t none=size;
+
+  // the successors, relative to begin
+  std::vector<std::vector<std::size_t>> successors(size);
+  std::vector<std::vector<std::size_t>> predecessors(size);
+
+  for(std::size_t l=0; l<size; l++)
+  {
+    const loct &loc=locs.loc_vector[begin+l];
+
+    if(loc.type==END_FUNCTION)
+      continue;
+
+    if(loc.type==GOTO &&
+       loc.branch_target.loc_number>=begin &&
+       loc.branch_target.loc_number<end)
+    {
+      successors[l].push_back(loc.branch_target.loc_number-begin);
+
+      if(loc.target->get_condition().is_true())
+        continue;
+    }
+
+    if(l+1<size)
+      successors[l].push_back(l+1);
+  }
+
+  for(std::size_t l=0; l<size; l++)
+    for(const auto s : successors[l])
+      predecessors[s].push_back(l);
+
+  // post-order on the reversed CFG, starting from the exit
+  std::vector<std::size_t> order(size, none), post_order;
+  post_order.reserve(size);
+
+  {
+    // pairs of location and next predecessor to visit
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    stack.push_back(std::make_pair(exit, 0));
+    order[exit]=0;
+
+    while(!stack.empty())
+    {
+      const std::size_t l=stack.back().first;
+      std::size_t &next=stack.back().second;
+
+      if(next<predecessors[l].size())
+      {
+        const std::size_t p=predecessors[l][next++];
+
+        if(order[p]==none)
+        {
+          order[p]=0; // on the stack
+          stack.push_back(std::make_pair(p, 0));
+        }
+      }
+      else
+      {
+        order[l]=post_order.size();
+        post_order.push_back(l);
+        stack.pop_back();
+      }
+    }
+  }
+
+  std::vector<std::size_t> ipdom(size, none);
+  ipdom[exit]=exit;
+
+  bool changed=true;
+
+  while(changed)
+  {
+    changed=false;
+
+    // reverse post-order, skipping the exit, which is last
+    for(std::size_t i=post_order.size()-1; i-->0;)
+    {
+      const std::size_t l=post_order[i];
+      std::size_t new_ipdom=none;
+
+      for(std::size_t s : successors[l])
+      {
+        if(ipdom[s]==none)
+          continue;
+
+        if(new_ipdom==none)
+        {
+          new_ipdom=s;
+          continue;
+        }
+
+        // intersect
+        std::size_t a=s, b=new_ipdom;
+
+        while(a!=b)
+        {
+          while(order[a]<order[b])
+            a=ipdom[a];
+          while(order[b]<order[a])
+            b=ipdom[b];
+        }
+
+        new_ipdom=a;
+      }
+
+      if(ipdom[l]!=new_ipdom)
+      {
+        ipdom[l]=new_ipdom;
+        changed=true;
+      }
+    }
+  }
+
+  for(std::size_t l=0; l<size; l++)
+    if(l!=exit && ipdom[l]!=none)
+      map[begin+l]=loc_reft(begin+ipdom[l]);
+}
@@ -0,0 +1,45 @@
+/*******************************************************************\
+
+Module: Post-Dominators for locs
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Post-Dominators for locs
+
+#ifndef CPROVER_GOTO_LOCS_POST_DOMINATORS_H
+#define CPROVER_GOTO_LOCS_POST_DOMINATORS_H
+
+#include <vector>
+
+#include "locs.h"
+
+#include <util/invariant.h>
+
+/// The immediate post-dominators of the locations, computed
+/// separately for each function, with calls as plain edges.
+/// Locations that cannot reach the end of their function,
+/// e.g., in non-terminating loops, have none.
+struct post_dominatorst
+{
+public:
+  explicit post_dominatorst(const locst &locs);
+
+  /// \return the immediate post-dominator, or nil
+  loc_reft operator[](const loc_reft loc_ref) const
+  {
+    PRECONDITION(!loc_ref.is_nil());
+    DATA_INVARIANT(loc_ref.loc_number<map.size(), "loc_ref ok");
+    return map[loc_ref.loc_number];
+  }
+
+protected:
+  typedef std::vector<loc_reft> mapt;
+  mapt map;
+
+  void build(const locst &, std::size_t begin, std::size_t end);
+};
+
+#endif // CPROVER_GOTO_LOCS_POST_DOMINATORS_H
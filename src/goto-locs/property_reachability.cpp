@@ -0,0 +1,109 @@
+/*******************************************************************\
+
+Module: Reachability of Properties for locs
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Reachability of Properties for locs
+
+#include "property_reachability.h"
+
+property_reachabilityt::property_reachabilityt(const locst &_locs):
+  locs(_locs)
+{
+  const std::size_t size=locs.size();
+  predecessors.resize(size);
+  reaches.resize(size, true);
+
+  // the entry points, for calls through function pointers
+  std::vector<std::size_t> entry_points;
+
+  for(const auto &f : locs.function_map)
+    if(!f.second.first_loc.is_nil())
+      entry_points.push_back(f.second.first_loc.loc_number);
+
+  for(std::size_t l=0; l<size; l++)
+  {
+    const loct &loc=locs.loc_vector[l];
+
+    switch(loc.type)
+    {
+    case END_FUNCTION:
+    case END_THREAD:
+      continue;
+
+    case GOTO:
+      predecessors[loc.branch_target.loc_number].push_back(l);
+
+      if(loc.target->get_condition().is_true())
+        continue;
+      break;
+
+    case START_THREAD:
+      predecessors[loc.branch_target.loc_number].push_back(l);
+      break;
+
+    case FUNCTION_CALL:
+      {
+        const exprt &function=
+          to_code_function_call(loc.target->code).function();
+
+        if(function.id()==ID_symbol)
+        {
+          const loc_reft first=locs.first_loc(
+            to_symbol_expr(function).get_identifier());
+
+          if(!first.is_nil())
+            predecessors[first.loc_number].push_back(l);
+        }
+        else
+        {
+          for(const auto e : entry_points)
+            predecessors[e].push_back(l);
+        }
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    if(l+1<size)
+      predecessors[l+1].push_back(l);
+  }
+}
+
+void property_reachabilityt::update(const std::vector<bool> &open)
+{
+  reaches.assign(locs.size(), false);
+
+  std::vector<std::size_t> stack;
+
+  for(std::size_t l=0; l<locs.size(); l++)
+  {
+    const loct &loc=locs.loc_vector[l];
+
+    if(loc.property_index!=loct::no_property &&
+       open[loc.property_index])
+    {
+      reaches[l]=true;
+      stack.push_back(l);
+    }
+  }
+
+  while(!stack.empty())
+  {
+    const std::size_t l=stack.back();
+    stack.pop_back();
+
+    for(const auto p : predecessors[l])
+      if(!reaches[p])
+      {
+        reaches[p]=true;
+        stack.push_back(p);
+      }
+  }
+}
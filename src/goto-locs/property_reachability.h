@@ -0,0 +1,50 @@
+/*******************************************************************\
+
+Module: Reachability of Properties for locs
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Reachability of Properties for locs
+
+#ifndef CPROVER_GOTO_LOCS_PROPERTY_REACHABILITY_H
+#define CPROVER_GOTO_LOCS_PROPERTY_REACHABILITY_H
+
+#include <vector>
+
+#include "locs.h"
+
+#include <util/invariant.h>
+
+/// Whether the locations may reach an assertion of a set of
+/// properties. Calls lead into their callees, which are taken
+/// to return, and START_THREAD into the new thread. Returns
+/// are not followed, and thus the locations of the call stack
+/// need to be considered separately.
+class property_reachabilityt
+{
+public:
+  explicit property_reachabilityt(const locst &);
+
+  /// recomputes the locations that may reach one of the
+  /// properties in \p open, indexed by locst::property_ids
+  void update(const std::vector<bool> &open);
+
+  bool operator[](const loc_reft loc_ref) const
+  {
+    PRECONDITION(!loc_ref.is_nil());
+    DATA_INVARIANT(loc_ref.loc_number<reaches.size(), "loc_ref ok");
+    return reaches[loc_ref.loc_number];
+  }
+
+protected:
+  const locst &locs;
+
+  // by loc_reft::loc_number
+  std::vector<std::vector<std::size_t>> predecessors;
+  std::vector<bool> reaches;
+};
+
+#endif // CPROVER_GOTO_LOCS_PROPERTY_REACHABILITY_H
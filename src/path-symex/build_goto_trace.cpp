@@ -12,6 +12,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/simplify_expr.h>
 
 #include "build_goto_trace.h"
+#include "var_map.h"
 
 /// follow state history to build a goto trace
 goto_tracet build_goto_trace(
@@ -19,10 +20,11 @@ goto_tracet build_goto_trace(
   const decision_proceduret &decision_procedure)
 {
   // follow the history in the state,
-  // but in a forwards-fashion
+  // but in a forwards-fashion, and along the
+  // merged paths that the solution takes
 
   std::vector<path_symex_step_reft> steps;
-  state.history.build_history(steps);
+  state.history.build_history(steps, decision_procedure);
 
   goto_tracet goto_trace;
 
@@ -33,8 +35,9 @@ goto_tracet build_goto_trace(
     goto_trace_stept trace_step;
 
     assert(!step.pc.is_nil());
-    trace_step.pc=step.pc.target;
-    trace_step.function_id=step.pc.function_identifier;
+    const loct &loc=state.config.locs[step.pc];
+    trace_step.pc=loc.target;
+    trace_step.function_id=loc.function_identifier;
     trace_step.thread_nr=step.thread_nr;
     trace_step.step_nr=step_nr;
     trace_step.hidden=step.hidden;
@@ -53,16 +56,20 @@ goto_tracet build_goto_trace(
         // instead process as
         //  new_array[index] = value
         const exprt index_ssa=to_with_expr(step.ssa_rhs).where();
-        const exprt index_value=decision_procedure.get(index_ssa);
+        const exprt index_value=
+          decision_procedure.get(name_ssa_symbols(index_ssa));
         trace_step.full_lhs=index_exprt(step.lhs, index_value);
         trace_step.full_lhs_value=
-          simplify_expr(decision_procedure.get(index_exprt(step.ssa_lhs, index_ssa)),
-                        state.config.ns);
+          simplify_expr(
+            decision_procedure.get(
+              name_ssa_symbols(index_exprt(step.ssa_lhs, index_ssa))),
+            state.config.ns);
       }
       else
       {
         trace_step.full_lhs=step.lhs;
-        trace_step.full_lhs_value=decision_procedure.get(step.ssa_lhs);
+        trace_step.full_lhs_value=
+          decision_procedure.get(name_ssa_symbols(step.ssa_lhs));
       }
 
       trace_step.type=goto_trace_stept::typet::ASSIGNMENT;
@@ -72,7 +79,8 @@ goto_tracet build_goto_trace(
     case DECL:
       trace_step.type=goto_trace_stept::typet::DECL;
       trace_step.full_lhs=step.lhs;
-      trace_step.full_lhs_value=decision_procedure.get(step.ssa_lhs);
+      trace_step.full_lhs_value=
+        decision_procedure.get(name_ssa_symbols(step.ssa_lhs));
       trace_step.assignment_type=goto_trace_stept::assignment_typet::STATE;
       break;
 
@@ -98,7 +106,8 @@ goto_tracet build_goto_trace(
       {
         trace_step.type=goto_trace_stept::typet::ASSIGNMENT;
         trace_step.full_lhs=step.lhs;
-        trace_step.full_lhs_value=decision_procedure.get(step.ssa_lhs);
+        trace_step.full_lhs_value=
+          decision_procedure.get(name_ssa_symbols(step.ssa_lhs));
         trace_step.assignment_type=
           goto_trace_stept::assignment_typet::ACTUAL_PARAMETER;
         // trace_step.lhs_object and trace_step.lhs_object_value
@@ -110,7 +119,8 @@ goto_tracet build_goto_trace(
         trace_step.called_function=step.called_function;
         trace_step.function_arguments.resize(step.function_arguments.size());
         for(std::size_t i=0; i<trace_step.function_arguments.size(); i++)
-          trace_step.function_arguments[i]=decision_procedure.get(step.function_arguments[i].ssa_lhs);
+          trace_step.function_arguments[i]=decision_procedure.get(
+            name_ssa_symbols(step.function_arguments[i].ssa_lhs));
       }
       break;
 
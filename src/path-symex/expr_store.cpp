@@ -0,0 +1,44 @@
+/*******************************************************************\
+
+Module: Hash-consing Store for SSA Expressions
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Hash-consing Store for SSA Expressions
+
+#include "expr_store.h"
+
+const expr_storet::storet::value_type &expr_storet::insert(const exprt &src)
+{
+  storet::const_iterator it=store.find(src);
+
+  if(it!=store.end())
+  {
+    hits++;
+    shared_nodes+=it->second;
+    return *it;
+  }
+
+  misses++;
+
+  // Not there yet. We store the operands first, such that
+  // equal subexpressions share one node as well.
+  exprt tmp=src;
+  std::size_t nodes=1;
+
+  if(tmp.has_operands())
+  {
+    for(auto &op : tmp.operands())
+    {
+      const auto &entry=insert(op);
+      op=entry.first;
+      nodes+=entry.second;
+    }
+  }
+
+  // references to elements of an unordered_map are stable
+  return *store.emplace(tmp, nodes).first;
+}
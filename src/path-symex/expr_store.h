@@ -0,0 +1,119 @@
+/*******************************************************************\
+
+Module: Hash-consing Store for SSA Expressions
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Hash-consing Store for SSA Expressions
+
+#ifndef CPROVER_PATH_SYMEX_EXPR_STORE_H
+#define CPROVER_PATH_SYMEX_EXPR_STORE_H
+
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <util/expr.h>
+
+/// Hash-conses the expressions produced by the read pipeline:
+/// structurally equal expressions returned by the store share
+/// one representation, bottom-up, i.e., including their operands.
+/// Two store-canonical expressions are equal if and only if
+/// they are the same node, see same().
+class expr_storet
+{
+public:
+  expr_storet():hits(0), misses(0), clears(0), shared_nodes(0)
+  {
+  }
+
+  /// \return an expression that is structurally equal to \p src
+  ///   and that shares its representation with any equal expression
+  ///   previously returned by the store
+  const exprt &operator()(const exprt &src)
+  {
+    return insert(src).first;
+  }
+
+  /// pointer equality on store-canonical expressions
+  static bool same(const exprt &a, const exprt &b)
+  {
+    return &a.read()==&b.read();
+  }
+
+  std::size_t size() const
+  {
+    return store.size();
+  }
+
+  void clear()
+  {
+    store.clear();
+    clears++;
+  }
+
+  // statistics
+  std::size_t hits, misses, clears;
+
+  // The owner clears the store, together with the caches keyed
+  // on its expressions, once it gets bigger than this. This must
+  // not happen while references into the store are in use, see
+  // path_symex_configt::bound_caches.
+  static const std::size_t max_size=1<<20;
+
+  // the number of expression nodes that did not need
+  // to be stored again thanks to sharing
+  std::size_t shared_nodes;
+
+  /// \return the size of an expression node, not counting
+  ///   the memory its containers of operands and of named
+  ///   subexpressions hold
+  static std::size_t node_size()
+  {
+    typedef std::decay<decltype(std::declval<const exprt &>().read())>::type
+      nodet;
+    return sizeof(nodet);
+  }
+
+  /// \return the approximate number of bytes held by the store;
+  ///   as the operands of an entry are entries, too, each entry
+  ///   holds one node of its own
+  std::size_t approx_memory() const
+  {
+    return
+      store.size()*(node_size()+sizeof(storet::value_type)+sizeof(void *))+
+      store.bucket_count()*sizeof(void *);
+  }
+
+protected:
+  // maps the canonical expression to its number of nodes
+  typedef std::unordered_map<exprt, std::size_t, irep_hash, irep_full_eq>
+    storet;
+  storet store;
+
+  const storet::value_type &insert(const exprt &);
+};
+
+/// Hash function for store-canonical expressions, which is O(1);
+/// use with expr_store_equalt as key of caches.
+struct expr_store_hasht
+{
+  std::size_t operator()(const exprt &expr) const
+  {
+    return std::hash<const void *>()(&expr.read());
+  }
+};
+
+struct expr_store_equalt
+{
+  bool operator()(const exprt &a, const exprt &b) const
+  {
+    return expr_storet::same(a, b);
+  }
+};
+
+#endif // CPROVER_PATH_SYMEX_EXPR_STORE_H
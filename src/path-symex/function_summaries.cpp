@@ -0,0 +1,80 @@
+/*******************************************************************\
+
+Module: Summaries of Concrete Function Calls
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Summaries of Concrete Function Calls
+
+#include "function_summaries.h"
+
+exprt function_summariest::key(
+  const irep_idt &function,
+  const exprt::operandst &arguments)
+{
+  exprt result(ID_function_call);
+  result.set(ID_identifier, function);
+  result.operands()=arguments;
+  return result;
+}
+
+const function_summariest::summariest *function_summariest::find(
+  const irep_idt &function,
+  const exprt::operandst &arguments) const
+{
+  mapt::const_iterator it=map.find(key(function, arguments));
+  return it==map.end()?nullptr:&it->second;
+}
+
+void function_summariest::insert(
+  const irep_idt &function,
+  const exprt::operandst &arguments,
+  summaryt summary)
+{
+  if(map.size()>=max_size)
+    map.clear();
+
+  summariest &summaries=map[key(function, arguments)];
+
+  if(summaries.size()<max_summaries_per_call)
+  {
+    summaries.push_back(std::move(summary));
+    recorded++;
+  }
+}
+
+bool function_summariest::is_concrete(const exprt &src)
+{
+  const irep_idt &id=src.id();
+
+  if(id==ID_constant || id==ID_string_constant)
+    return true;
+  else if(id==ID_address_of)
+    return is_concrete_address(to_address_of_expr(src).object());
+  else if(id==ID_typecast || id==ID_struct || id==ID_union ||
+          id==ID_array || id==ID_array_of || id==ID_vector ||
+          id==ID_with)
+    return !src.operands().empty() && is_concrete(src.operands());
+  else
+    return false;
+}
+
+bool function_summariest::is_concrete_address(const exprt &src)
+{
+  const irep_idt &id=src.id();
+
+  if(id==ID_symbol)
+    return !src.get_bool(ID_C_SSA_symbol);
+  else if(id==ID_string_constant)
+    return true;
+  else if(id==ID_member)
+    return is_concrete_address(to_member_expr(src).struct_op());
+  else if(id==ID_index)
+    return is_concrete_address(to_index_expr(src).array()) &&
+           to_index_expr(src).index().is_constant();
+  else
+    return false;
+}
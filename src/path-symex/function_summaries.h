@@ -0,0 +1,109 @@
+/*******************************************************************\
+
+Module: Summaries of Concrete Function Calls
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Summaries of Concrete Function Calls
+
+#ifndef CPROVER_PATH_SYMEX_FUNCTION_SUMMARIES_H
+#define CPROVER_PATH_SYMEX_FUNCTION_SUMMARIES_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <util/irep_hash.h>
+#include <util/std_expr.h>
+
+/// Remembers the effect of calls that only depend on concrete
+/// values: the arguments, and the values of the variables that the
+/// callee reads before writing them. A call with the same arguments
+/// in a state with the same values for these variables has the same
+/// effect, and can thus be replayed instead of executed.
+class function_summariest
+{
+public:
+  function_summariest():
+    recorded(0), replayed(0), enabled(false)
+  {
+  }
+
+  void enable()
+  {
+    enabled=true;
+  }
+
+  bool is_enabled() const
+  {
+    return enabled;
+  }
+
+  struct summaryt
+  {
+    // pairs of var_infot::id and value
+    typedef std::vector<std::pair<unsigned, exprt>> valuest;
+
+    // the values of the variables read before being written
+    valuest reads;
+
+    // the values of the variables written, except for
+    // the locals of the callee
+    valuest writes;
+
+    // nil if there is none
+    exprt return_value;
+  };
+
+  typedef std::vector<summaryt> summariest;
+
+  /// \return the summaries for the given call, or nullptr
+  const summariest *find(
+    const irep_idt &function,
+    const exprt::operandst &arguments) const;
+
+  void insert(
+    const irep_idt &function,
+    const exprt::operandst &arguments,
+    summaryt summary);
+
+  /// \return whether \p src is a constant, or built from constants
+  ///   and addresses of objects with constant offsets
+  static bool is_concrete(const exprt &src);
+
+  static bool is_concrete(const exprt::operandst &src)
+  {
+    for(const auto &op : src)
+      if(!is_concrete(op))
+        return false;
+
+    return true;
+  }
+
+  // statistics
+  std::size_t recorded, replayed;
+
+  // we clear the summaries when there are more than this
+  static const std::size_t max_size=1<<12;
+
+  // the number of summaries kept for the same arguments
+  static const std::size_t max_summaries_per_call=8;
+
+protected:
+  bool enabled;
+
+  typedef std::unordered_map<
+    exprt, summariest, irep_hash, irep_full_eq> mapt;
+  mapt map;
+
+  static exprt key(
+    const irep_idt &function,
+    const exprt::operandst &arguments);
+
+  static bool is_concrete_address(const exprt &);
+};
+
+#endif // CPROVER_PATH_SYMEX_FUNCTION_SUMMARIES_H
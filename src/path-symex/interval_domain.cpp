@@ -0,0 +1,354 @@
+/*******************************************************************\
+
+Module: Intervals of SSA Symbols
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Intervals of SSA Symbols
+
+#include "interval_domain.h"
+
+#include <algorithm>
+
+#include <util/arith_tools.h>
+#include <util/namespace.h>
+#include <util/std_expr.h>
+
+void intervalt::meet(const intervalt &other)
+{
+  if(other.lower_set && (!lower_set || other.lower>lower))
+  {
+    lower_set=true;
+    lower=other.lower;
+  }
+
+  if(other.upper_set && (!upper_set || other.upper<upper))
+  {
+    upper_set=true;
+    upper=other.upper;
+  }
+}
+
+void intervalt::join(const intervalt &other)
+{
+  if(!other.lower_set)
+    lower_set=false;
+  else if(lower_set && other.lower<lower)
+    lower=other.lower;
+
+  if(!other.upper_set)
+    upper_set=false;
+  else if(upper_set && other.upper>upper)
+    upper=other.upper;
+}
+
+intervalt interval_domaint::type_range(const typet &type)
+{
+  if(type.id()==ID_unsignedbv)
+  {
+    const std::size_t width=to_unsignedbv_type(type).get_width();
+    return intervalt(0, power(2, width)-1);
+  }
+  else if(type.id()==ID_signedbv)
+  {
+    const std::size_t width=to_signedbv_type(type).get_width();
+    return intervalt(-power(2, width-1), power(2, width-1)-1);
+  }
+  else
+    return intervalt();
+}
+
+intervalt interval_domaint::eval(
+  const exprt &src,
+  const namespacet &ns) const
+{
+  const intervalt range=type_range(ns.follow(src.type()));
+
+  if(range.is_top())
+    return range;
+
+  intervalt result;
+
+  if(src.id()==ID_constant)
+  {
+    mp_integer value;
+    if(!to_integer(to_constant_expr(src), value))
+      result=intervalt(value, value);
+  }
+  else if(src.id()==ID_symbol)
+  {
+    mapt::const_iterator it=map.find(ssa_key(to_symbol_expr(src)));
+    if(it!=map.end())
+      result=it->second;
+  }
+  else if(src.id()==ID_typecast)
+  {
+    result=eval(to_typecast_expr(src).op(), ns);
+  }
+  else if(src.id()==ID_if)
+  {
+    result=eval(to_if_expr(src).true_case(), ns);
+    result.join(eval(to_if_expr(src).false_case(), ns));
+  }
+  else if(src.id()==ID_unary_minus)
+  {
+    const intervalt op=eval(to_unary_minus_expr(src).op(), ns);
+    if(op.is_bounded())
+      result=intervalt(-op.upper, -op.lower);
+  }
+  else if((src.id()==ID_plus || src.id()==ID_mult) &&
+          src.operands().size()>=2)
+  {
+    result=eval(src.op0(), ns);
+
+    for(std::size_t i=1; i<src.operands().size() && result.is_bounded(); i++)
+    {
+      const intervalt op=eval(src.operands()[i], ns);
+
+      if(!op.is_bounded())
+        result=intervalt();
+      else if(src.id()==ID_plus)
+        result=intervalt(result.lower+op.lower, result.upper+op.upper);
+      else
+      {
+        const mp_integer products[]=
+        {
+          result.lower*op.lower, result.lower*op.upper,
+          result.upper*op.lower, result.upper*op.upper
+        };
+
+        result=intervalt(
+          *std::min_element(products, products+4),
+          *std::max_element(products, products+4));
+      }
+    }
+  }
+  else if(src.id()==ID_minus && src.operands().size()==2)
+  {
+    const intervalt op0=eval(src.op0(), ns);
+    const intervalt op1=eval(src.op1(), ns);
+
+    if(op0.is_bounded() && op1.is_bounded())
+      result=intervalt(op0.lower-op1.upper, op0.upper-op1.lower);
+  }
+
+  // the value may have wrapped around
+  if(!range.contains(result))
+    return range;
+
+  return result;
+}
+
+void interval_domaint::assign(
+  const symbol_exprt &ssa_lhs,
+  const exprt &ssa_rhs,
+  const namespacet &ns)
+{
+  assign(ssa_lhs, eval(ssa_rhs, ns), ns);
+}
+
+void interval_domaint::assign(
+  const symbol_exprt &ssa_lhs,
+  const intervalt &value,
+  const namespacet &ns)
+{
+  // only worth storing when narrower than the type
+  if(value.is_bounded() &&
+     !value.contains(type_range(ns.follow(ssa_lhs.type()))))
+    map[ssa_key(ssa_lhs)]=value;
+}
+
+void interval_domaint::join(const interval_domaint &other)
+{
+  mapt::iterator it=map.begin();
+  mapt::const_iterator o_it=other.map.begin();
+
+  // symbols missing on either side are unconstrained there
+  while(it!=map.end())
+  {
+    while(o_it!=other.map.end() && o_it->first<it->first)
+      ++o_it;
+
+    if(o_it==other.map.end() || it->first<o_it->first)
+      it=map.erase(it);
+    else
+    {
+      it->second.join(o_it->second);
+      ++it;
+    }
+  }
+}
+
+tvt interval_domaint::decide(
+  const exprt &ssa_guard,
+  const namespacet &ns) const
+{
+  if(ssa_guard.is_true())
+    return tvt(true);
+  else if(ssa_guard.is_false())
+    return tvt(false);
+  else if(ssa_guard.id()==ID_not)
+    return !decide(to_not_expr(ssa_guard).op(), ns);
+  else if(ssa_guard.id()==ID_and || ssa_guard.id()==ID_or)
+  {
+    // the value that decides the conjunction or disjunction
+    const bool dominant=ssa_guard.id()==ID_or;
+    bool all_known=true;
+
+    forall_operands(it, ssa_guard)
+    {
+      const tvt op=decide(*it, ns);
+
+      if(op.is_unknown())
+        all_known=false;
+      else if(op.is_true()==dominant)
+        return tvt(dominant);
+    }
+
+    return all_known?tvt(!dominant):tvt::unknown();
+  }
+  else if(ssa_guard.operands().size()!=2)
+    return tvt::unknown();
+
+  const irep_idt &id=ssa_guard.id();
+
+  if(id!=ID_lt && id!=ID_le && id!=ID_gt && id!=ID_ge &&
+     id!=ID_equal && id!=ID_notequal)
+    return tvt::unknown();
+
+  // normalise to a < b, a <= b or a = b
+  const bool swap=(id==ID_gt || id==ID_ge);
+  const intervalt a=eval(swap?ssa_guard.op1():ssa_guard.op0(), ns);
+  const intervalt b=eval(swap?ssa_guard.op0():ssa_guard.op1(), ns);
+
+  if(id==ID_lt || id==ID_gt)
+  {
+    if(a.upper_set && b.lower_set && a.upper<b.lower)
+      return tvt(true);
+    if(a.lower_set && b.upper_set && a.lower>=b.upper)
+      return tvt(false);
+  }
+  else if(id==ID_le || id==ID_ge)
+  {
+    if(a.upper_set && b.lower_set && a.upper<=b.lower)
+      return tvt(true);
+    if(a.lower_set && b.upper_set && a.lower>b.upper)
+      return tvt(false);
+  }
+  else // ID_equal, ID_notequal
+  {
+    const bool equal=id==ID_equal;
+
+    if(a.is_point() && b.is_point() && a.lower==b.lower)
+      return tvt(equal);
+
+    if((a.upper_set && b.lower_set && a.upper<b.lower) ||
+       (a.lower_set && b.upper_set && a.lower>b.upper))
+      return tvt(!equal);
+  }
+
+  return tvt::unknown();
+}
+
+void interval_domaint::assume(
+  const exprt &ssa_guard,
+  bool polarity,
+  const namespacet &ns)
+{
+  const irep_idt &id=ssa_guard.id();
+
+  if(id==ID_not)
+    assume(to_not_expr(ssa_guard).op(), !polarity, ns);
+  else if((id==ID_and && polarity) || (id==ID_or && !polarity))
+  {
+    forall_operands(it, ssa_guard)
+      assume(*it, polarity, ns);
+  }
+  else if(ssa_guard.operands().size()==2)
+  {
+    irep_idt relation;
+
+    if(id==ID_lt)
+      relation=polarity?ID_lt:ID_ge;
+    else if(id==ID_le)
+      relation=polarity?ID_le:ID_gt;
+    else if(id==ID_gt)
+      relation=polarity?ID_gt:ID_le;
+    else if(id==ID_ge)
+      relation=polarity?ID_ge:ID_lt;
+    else if(id==ID_equal)
+      relation=polarity?ID_equal:ID_notequal;
+    else if(id==ID_notequal)
+      relation=polarity?ID_notequal:ID_equal;
+    else
+      return;
+
+    // a R b, and b R' a with R' the mirrored relation
+    irep_idt mirrored=relation;
+
+    if(relation==ID_lt)
+      mirrored=ID_gt;
+    else if(relation==ID_le)
+      mirrored=ID_ge;
+    else if(relation==ID_gt)
+      mirrored=ID_lt;
+    else if(relation==ID_ge)
+      mirrored=ID_le;
+
+    refine(ssa_guard.op0(), relation, ssa_guard.op1(), ns);
+    refine(ssa_guard.op1(), mirrored, ssa_guard.op0(), ns);
+  }
+}
+
+/// refines the interval of \p lhs, if it is an SSA symbol,
+/// given that lhs \p relation rhs holds
+void interval_domaint::refine(
+  const exprt &lhs,
+  const irep_idt &relation,
+  const exprt &rhs,
+  const namespacet &ns)
+{
+  // look through casts that preserve the value
+  const exprt *symbol=&lhs;
+
+  while(symbol->id()==ID_typecast &&
+        type_range(ns.follow(symbol->type())).contains(
+          type_range(ns.follow(to_typecast_expr(*symbol).op().type()))))
+    symbol=&to_typecast_expr(*symbol).op();
+
+  if(symbol->id()!=ID_symbol)
+    return;
+
+  intervalt value=eval(*symbol, ns);
+
+  if(value.is_top())
+    return; // not an integer
+
+  const intervalt bound=eval(rhs, ns);
+
+  if(relation==ID_lt && bound.upper_set)
+    value.meet(intervalt(value.lower, bound.upper-1));
+  else if(relation==ID_le && bound.upper_set)
+    value.meet(intervalt(value.lower, bound.upper));
+  else if(relation==ID_gt && bound.lower_set)
+    value.meet(intervalt(bound.lower+1, value.upper));
+  else if(relation==ID_ge && bound.lower_set)
+    value.meet(intervalt(bound.lower, value.upper));
+  else if(relation==ID_equal)
+    value.meet(bound);
+  else if(relation==ID_notequal && bound.is_point())
+  {
+    if(value.lower==bound.lower)
+      value.lower+=1;
+    else if(value.upper==bound.lower)
+      value.upper-=1;
+  }
+
+  // an empty interval means that the path is infeasible,
+  // which is left to the solver
+  if(!value.is_empty())
+    map[ssa_key(to_symbol_expr(*symbol))]=value;
+}
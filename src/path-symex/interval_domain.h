@@ -0,0 +1,120 @@
+/*******************************************************************\
+
+Module: Intervals of SSA Symbols
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Intervals of SSA Symbols
+
+#ifndef CPROVER_PATH_SYMEX_INTERVAL_DOMAIN_H
+#define CPROVER_PATH_SYMEX_INTERVAL_DOMAIN_H
+
+#include <map>
+
+#include <util/expr.h>
+#include <util/mp_arith.h>
+#include <util/threeval.h>
+
+#include "var_map.h"
+
+class namespacet;
+class symbol_exprt;
+
+/// A set of integers given by optional lower and upper bounds
+struct intervalt
+{
+  bool lower_set, upper_set;
+  mp_integer lower, upper;
+
+  intervalt():lower_set(false), upper_set(false)
+  {
+  }
+
+  intervalt(const mp_integer &_lower, const mp_integer &_upper):
+    lower_set(true), upper_set(true), lower(_lower), upper(_upper)
+  {
+  }
+
+  bool is_top() const
+  {
+    return !lower_set && !upper_set;
+  }
+
+  bool is_bounded() const
+  {
+    return lower_set && upper_set;
+  }
+
+  bool is_empty() const
+  {
+    return is_bounded() && lower>upper;
+  }
+
+  bool is_point() const
+  {
+    return is_bounded() && lower==upper;
+  }
+
+  bool contains(const intervalt &other) const
+  {
+    return (!lower_set || (other.lower_set && other.lower>=lower)) &&
+           (!upper_set || (other.upper_set && other.upper<=upper));
+  }
+
+  void meet(const intervalt &other);
+  void join(const intervalt &other);
+};
+
+/// Tracks intervals for the integer-typed SSA symbols of a path.
+/// As SSA symbols are never reassigned, the facts do not expire;
+/// they are obtained from assignments and from the branches
+/// and assumptions along the path.
+class interval_domaint
+{
+public:
+  /// records the interval of the value assigned to \p ssa_lhs
+  void assign(
+    const symbol_exprt &ssa_lhs,
+    const exprt &ssa_rhs,
+    const namespacet &);
+
+  /// records that the value of \p ssa_lhs is in \p value
+  void assign(
+    const symbol_exprt &ssa_lhs,
+    const intervalt &value,
+    const namespacet &);
+
+  /// keeps the facts that hold in this or in \p other
+  void join(const interval_domaint &other);
+
+  /// \return whether \p ssa_guard holds for all values in the domain
+  tvt decide(const exprt &ssa_guard, const namespacet &) const;
+
+  /// refines the domain assuming \p ssa_guard evaluates to \p polarity
+  void assume(const exprt &ssa_guard, bool polarity, const namespacet &);
+
+  intervalt eval(const exprt &, const namespacet &) const;
+
+  std::size_t size() const
+  {
+    return map.size();
+  }
+
+  typedef std::map<ssa_keyt, intervalt> mapt;
+
+protected:
+  mapt map;
+
+  void refine(
+    const exprt &lhs,
+    const irep_idt &relation,
+    const exprt &rhs,
+    const namespacet &);
+
+  static intervalt type_range(const typet &);
+};
+
+#endif // CPROVER_PATH_SYMEX_INTERVAL_DOMAIN_H
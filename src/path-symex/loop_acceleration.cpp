@@ -0,0 +1,259 @@
+/*******************************************************************\
+
+Module: Acceleration of Simple Counting Loops
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Acceleration of Simple Counting Loops
+
+#include "loop_acceleration.h"
+
+#include <util/arith_tools.h>
+#include <util/simplify_expr.h>
+
+#include <goto-locs/loop_heads.h>
+
+void loop_accelerationt::build(const locst &locs)
+{
+  loops.clear();
+  loop_at.assign(locs.size(), no_loop);
+
+  const loop_headst loop_heads(locs);
+
+  for(loc_reft l=locs.begin(); l!=locs.end(); ++l)
+  {
+    if(!loop_heads[l])
+      continue;
+
+    loopt loop;
+
+    if(analyse(locs, l, loop))
+    {
+      loop_at[l.loc_number]=loops.size();
+      loops.push_back(loop);
+    }
+  }
+}
+
+bool loop_accelerationt::analyse(
+  const locst &locs,
+  loc_reft head,
+  loopt &loop) const
+{
+  // the head leaves the loop
+  const loct &head_loc=locs[head];
+
+  if(head_loc.type!=GOTO ||
+     head_loc.target->get_condition().is_true())
+    return false;
+
+  loop.exit=head_loc.branch_target;
+
+  if(loop.exit.loc_number<=head.loc_number+1)
+    return false;
+
+  // the instruction before the exit jumps back to the head
+  const loct &back_loc=locs[loc_reft(loop.exit.loc_number-1)];
+
+  if(!back_loc.backwards_goto ||
+     back_loc.branch_target!=head ||
+     !back_loc.target->get_condition().is_true() ||
+     back_loc.function_identifier!=head_loc.function_identifier)
+    return false;
+
+  // the body is a sequence of assignments
+  for(unsigned l=head.loc_number+1; l<loop.exit.loc_number-1; l++)
+  {
+    const loct &loc=locs[loc_reft(l)];
+
+    if(loc.type==ASSIGN)
+    {
+      const code_assignt &code_assign=loc.target->get_assign();
+      if(!get_update(code_assign.lhs(), code_assign.rhs(), loop))
+        return false;
+    }
+    else if(loc.type!=SKIP && loc.type!=LOCATION)
+      return false;
+  }
+
+  // the increments are invariant, or induction variables
+  for(std::size_t u=0; u<loop.updates.size(); u++)
+  {
+    updatet &update=loop.updates[u];
+
+    if(is_invariant(loop, update.increment))
+      continue;
+
+    const std::size_t induction=find_update(loop, update.increment);
+
+    if(induction==updatet::no_update ||
+       induction==u ||
+       !is_invariant(loop, loop.updates[induction].increment))
+      return false;
+
+    update.induction=induction;
+    update.induction_first=induction<u;
+  }
+
+  return get_condition(head_loc.target->get_condition(), loop);
+}
+
+/// recognises lhs=lhs+increment and lhs=lhs-constant
+bool loop_accelerationt::get_update(
+  const exprt &lhs,
+  const exprt &rhs,
+  loopt &loop) const
+{
+  if(lhs.id()!=ID_symbol)
+    return false;
+
+  const typet &type=ns.follow(lhs.type());
+
+  if(type.id()!=ID_signedbv && type.id()!=ID_unsignedbv)
+    return false;
+
+  // each variable is updated once
+  if(find_update(loop, lhs)!=updatet::no_update)
+    return false;
+
+  updatet update(to_symbol_expr(lhs));
+
+  if(rhs.id()==ID_plus && rhs.operands().size()==2)
+  {
+    if(rhs.op0()==lhs)
+      update.increment=simplify_expr(rhs.op1(), ns);
+    else if(rhs.op1()==lhs)
+      update.increment=simplify_expr(rhs.op0(), ns);
+    else
+      return false;
+
+    if(update.increment.is_constant() &&
+       !to_integer(to_constant_expr(update.increment), update.step))
+      update.constant_step=true;
+  }
+  else if(rhs.id()==ID_minus && rhs.operands().size()==2 &&
+          rhs.op0()==lhs)
+  {
+    const exprt decrement=simplify_expr(rhs.op1(), ns);
+
+    if(!decrement.is_constant() ||
+       to_integer(to_constant_expr(decrement), update.step))
+      return false;
+
+    update.step=-update.step;
+    update.constant_step=true;
+    update.increment=unary_minus_exprt(decrement, decrement.type());
+  }
+  else
+    return false;
+
+  if(update.increment.type()!=lhs.type())
+    return false;
+
+  loop.updates.push_back(update);
+  return true;
+}
+
+/// recognises the exit condition !(counter R bound)
+bool loop_accelerationt::get_condition(const exprt &guard, loopt &loop) const
+{
+  exprt condition;
+  irep_idt relation;
+
+  if(guard.id()==ID_not)
+  {
+    condition=to_not_expr(guard).op();
+    relation=condition.id();
+  }
+  else
+  {
+    condition=guard;
+
+    if(guard.id()==ID_lt)
+      relation=ID_ge;
+    else if(guard.id()==ID_le)
+      relation=ID_gt;
+    else if(guard.id()==ID_gt)
+      relation=ID_le;
+    else if(guard.id()==ID_ge)
+      relation=ID_lt;
+    else if(guard.id()==ID_equal)
+      relation=ID_notequal;
+    else
+      return false;
+  }
+
+  if(relation!=ID_lt && relation!=ID_le &&
+     relation!=ID_gt && relation!=ID_ge &&
+     relation!=ID_notequal)
+    return false;
+
+  if(condition.operands().size()!=2)
+    return false;
+
+  // the counter goes to the left
+  std::size_t counter=find_update(loop, condition.op0());
+  loop.bound=condition.op1();
+
+  if(counter==updatet::no_update)
+  {
+    counter=find_update(loop, condition.op1());
+    loop.bound=condition.op0();
+
+    if(relation==ID_lt)
+      relation=ID_gt;
+    else if(relation==ID_le)
+      relation=ID_ge;
+    else if(relation==ID_gt)
+      relation=ID_lt;
+    else if(relation==ID_ge)
+      relation=ID_le;
+  }
+
+  if(counter==updatet::no_update ||
+     !loop.updates[counter].constant_step ||
+     loop.updates[counter].step==0 ||
+     !is_invariant(loop, loop.bound))
+    return false;
+
+  loop.counter=counter;
+  loop.relation=relation;
+
+  return true;
+}
+
+/// \return the index of the update of the variable \p src,
+///   or updatet::no_update
+std::size_t loop_accelerationt::find_update(
+  const loopt &loop,
+  const exprt &src)
+{
+  if(src.id()==ID_symbol)
+  {
+    const irep_idt &identifier=to_symbol_expr(src).get_identifier();
+
+    for(std::size_t u=0; u<loop.updates.size(); u++)
+      if(loop.updates[u].lhs.get_identifier()==identifier)
+        return u;
+  }
+
+  return updatet::no_update;
+}
+
+/// \return true if \p src does not change in the loop
+bool loop_accelerationt::is_invariant(const loopt &loop, const exprt &src)
+{
+  if(src.id()==ID_symbol)
+    return find_update(loop, src)==updatet::no_update;
+  else if(src.id()==ID_dereference || src.id()==ID_side_effect)
+    return false;
+
+  forall_operands(it, src)
+    if(!is_invariant(loop, *it))
+      return false;
+
+  return true;
+}
@@ -0,0 +1,116 @@
+/*******************************************************************\
+
+Module: Acceleration of Simple Counting Loops
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Acceleration of Simple Counting Loops
+
+#ifndef CPROVER_PATH_SYMEX_LOOP_ACCELERATION_H
+#define CPROVER_PATH_SYMEX_LOOP_ACCELERATION_H
+
+#include <limits>
+#include <vector>
+
+#include <util/mp_arith.h>
+#include <util/std_expr.h>
+
+#include <goto-locs/locs.h>
+
+/// Finds loops of the form
+///
+///   head: IF !(i R b) GOTO exit
+///         x1=x1+e1; ...; xn=xn+en;
+///         GOTO head
+///   exit:
+///
+/// where i is one of the xj with a constant increment, b is
+/// loop-invariant, and each ej is either loop-invariant or another
+/// xk with a loop-invariant increment. When the state reaches the
+/// head with constant i and b, symex can execute all iterations at
+/// once using closed forms for the xj.
+class loop_accelerationt
+{
+public:
+  explicit loop_accelerationt(const namespacet &_ns):
+    accelerated(0), saved_iterations(0), ns(_ns)
+  {
+  }
+
+  void build(const locst &);
+
+  bool is_enabled() const
+  {
+    return !loops.empty();
+  }
+
+  struct updatet
+  {
+    symbol_exprt lhs;
+    exprt increment;
+
+    // set if the increment is a constant
+    bool constant_step;
+    mp_integer step;
+
+    // if the increment is another variable updated in the loop,
+    // the index of its update, and whether it is updated before
+    std::size_t induction;
+    bool induction_first;
+
+    static const std::size_t no_update=
+      std::numeric_limits<std::size_t>::max();
+
+    explicit updatet(const symbol_exprt &_lhs):
+      lhs(_lhs),
+      constant_step(false),
+      induction(no_update),
+      induction_first(false)
+    {
+    }
+  };
+
+  struct loopt
+  {
+    loc_reft exit;
+
+    // the loop runs while 'counter relation bound'
+    std::size_t counter;
+    irep_idt relation;
+    exprt bound;
+
+    std::vector<updatet> updates;
+  };
+
+  /// \return the loop with given head, or nullptr
+  const loopt *operator[](loc_reft head) const
+  {
+    if(head.loc_number>=loop_at.size() || loop_at[head.loc_number]==no_loop)
+      return nullptr;
+    return &loops[loop_at[head.loc_number]];
+  }
+
+  // statistics
+  std::size_t accelerated, saved_iterations;
+
+protected:
+  const namespacet &ns;
+
+  std::vector<loopt> loops;
+
+  // indexed by loc_reft::loc_number of the head
+  std::vector<std::size_t> loop_at;
+
+  static const std::size_t no_loop=std::numeric_limits<std::size_t>::max();
+
+  bool analyse(const locst &, loc_reft head, loopt &) const;
+  bool get_update(const exprt &lhs, const exprt &rhs, loopt &) const;
+  bool get_condition(const exprt &guard, loopt &) const;
+  static std::size_t find_update(const loopt &, const exprt &);
+  static bool is_invariant(const loopt &, const exprt &);
+};
+
+#endif // CPROVER_PATH_SYMEX_LOOP_ACCELERATION_H
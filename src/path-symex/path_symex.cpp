@@ -16,7 +16,6 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/expr_initializer.h>
 #include <util/pointer_offset_size.h>
 #include <util/prefix.h>
-#include <util/simplify_expr.h>
 #include <util/std_expr.h>
 #include <util/string2int.h>
 
@@ -27,6 +26,68 @@ Author: Daniel Kroening, kroening@kroening.com
 #include "path_symex.h"
 #include "path_symex_class.h"
 
+bool path_symext::propagate(
+  const path_symex_configt &config,
+  const exprt &src)
+{
+  switch(config.propagation)
+  {
+  case propagationt::NONE:
+    // dereferencing needs the pointers
+    return may_hold_pointer(src.type(), config.ns) && propagate(src);
+
+  case propagationt::SIMPLE:
+    return propagate(src);
+
+  case propagationt::AGGRESSIVE:
+    {
+      std::size_t budget=max_propagation_size;
+      return propagate_aggressive(src, budget);
+    }
+  }
+
+  UNREACHABLE;
+}
+
+bool path_symext::propagate_aggressive(
+  const exprt &src,
+  std::size_t &budget)
+{
+  if(budget==0)
+    return false;
+
+  budget--;
+
+  const irep_idt &id=src.id();
+
+  if(src.is_constant() ||
+     id==ID_symbol ||
+     id==ID_address_of)
+    return true;
+  else if(id==ID_member || id==ID_index || id==ID_with ||
+          id==ID_typecast || id==ID_if ||
+          id==ID_array || id==ID_array_of || id==ID_vector ||
+          id==ID_struct || id==ID_union ||
+          id==ID_byte_extract_little_endian ||
+          id==ID_byte_extract_big_endian ||
+          id==ID_plus || id==ID_minus || id==ID_mult ||
+          id==ID_div || id==ID_mod || id==ID_unary_minus ||
+          id==ID_bitand || id==ID_bitor || id==ID_bitxor || id==ID_bitnot ||
+          id==ID_shl || id==ID_ashr || id==ID_lshr ||
+          id==ID_not || id==ID_and || id==ID_or ||
+          id==ID_equal || id==ID_notequal ||
+          id==ID_lt || id==ID_le || id==ID_gt || id==ID_ge)
+  {
+    forall_operands(it, src)
+      if(!propagate_aggressive(*it, budget))
+        return false;
+
+    return true;
+  }
+  else
+    return false;
+}
+
 bool path_symext::propagate(const exprt &src)
 {
   // propagate things that are 'simple enough'
@@ -115,6 +176,8 @@ void path_symext::assign(
 
     if(statement==ID_allocate)
     {
+      // the object is a different one for every call
+      state.summary_recording.reset();
       symex_allocate(state, lhs, side_effect_expr);
       return;
     }
@@ -122,6 +185,7 @@ void path_symext::assign(
             statement==ID_cpp_new ||
             statement==ID_cpp_new_array)
     {
+      state.summary_recording.reset();
       symex_new(state, lhs, side_effect_expr);
       return;
     }
@@ -164,6 +228,14 @@ void path_symext::assign(
 
   //const exprt dereferenced_lhs=dereference_exprt(lhs_address);
 
+  // Whole objects are copied by letting the lhs share the SSA
+  // symbols of the rhs, see path_symex_copy.cpp.
+  const exprt copy_src=copy_source(state, rhs);
+
+  if(copy_src.is_not_nil() &&
+     !copy_object(state, dereferenced_lhs, copy_src))
+    return;
+
   // now SSA the lhs, no propagation
   const exprt ssa_lhs=state.read_no_propagate(dereferenced_lhs);
 
@@ -239,12 +311,12 @@ void path_symext::symex_va_arg_next(
       else
         id=base+"0";
 
-      const var_mapt::var_infot &var_info=state.config.var_map[id];
+      const var_mapt::var_infot *var_info=state.config.var_map.find(id);
 
-      if(var_info.full_identifier==id)
+      if(var_info!=nullptr)
       {
         const path_symex_statet::var_statet &var_state
-          =state.get_var_state(var_info);
+          =state.get_var_state(*var_info);
         const exprt symbol_expr=symbol_exprt(id, var_state.ssa_symbol.type());
         rhs=address_of_exprt(symbol_expr);
         rhs.make_typecast(lhs.type());
@@ -268,23 +340,22 @@ void path_symext::assign_rec_symbol(
   // These are expected to be SSA symbols
   assert(ssa_lhs.get_bool(ID_C_SSA_symbol));
 
-  const irep_idt &full_identifier=ssa_lhs.get(ID_C_full_identifier);
-
   #ifdef DEBUG
-  const irep_idt &ssa_identifier=expr.get_identifier();
+  const irep_idt &ssa_identifier=ssa_lhs.get_identifier();
   std::cout << "SSA symbol identifier: " << ssa_identifier << '\n';
-  std::cout << "full identifier: " << full_identifier << '\n';
+  std::cout << "full identifier: "
+            << ssa_lhs.get(ID_C_full_identifier) << '\n';
   #endif
 
-  var_mapt::var_infot &var_info=state.config.var_map[full_identifier];
-  assert(var_info.full_identifier==full_identifier);
+  // the SSA symbol carries its variable
+  var_mapt::var_infot &var_info=state.config.var_map.from_ssa(ssa_lhs);
 
   // increase the SSA counter and produce new SSA symbol expression
   var_info.increment_ssa_counter();
   symbol_exprt new_ssa_lhs=var_info.ssa_symbol();
 
   // ssa-ify the size
-  if(var_mapt::is_unbounded_array(new_ssa_lhs.type()))
+  if(state.config.var_map.is_unbounded_array(new_ssa_lhs.type()))
   {
     // disabled to preserve type consistency
     // exprt &size=to_array_type(new_ssa_lhs.type()).size();
@@ -295,6 +366,9 @@ void path_symext::assign_rec_symbol(
   std::cout << "new_ssa_lhs: " << new_ssa_lhs.get_identifier() << '\n';
   #endif
 
+  if(state.summary_recording)
+    state.summary_write(var_info);
+
   // record new state of lhs
   {
     // warning: reference var_state is not stable
@@ -323,9 +397,14 @@ void path_symext::assign_rec_symbol(
     // propagate the rhs?
     // warning: reference var_state is not stable
     path_symex_statet::var_statet &var_state=state.get_var_state(var_info);
-    var_state.value=propagate(ssa_rhs)?ssa_rhs:nil_exprt();
+    var_state.value=
+      propagate(state.config, ssa_rhs)?ssa_rhs:nil_exprt();
+
+    state.intervals.assign(new_ssa_lhs, ssa_rhs, state.config.ns);
   }
 
+  state.new_version(var_info, state.get_var_state(var_info));
+
   // record the step
   state.record_step();
   stept &step=*state.history;
@@ -398,7 +477,7 @@ void path_symext::assign_rec_index(
   const auto &index_expr=to_index_expr(ssa_lhs);
 
   // This must be an unbounded array.
-  if(!var_mapt::is_unbounded_array(index_expr.array().type()))
+  if(!state.config.var_map.is_unbounded_array(index_expr.array().type()))
     throw "unexpected array index on lhs";
 
   const exprt new_ssa_lhs=index_expr.array();
@@ -526,12 +605,11 @@ void path_symext::assign_rec(
         new_rhs=ssa_rhs.operands()[i];
       else
       {
-        new_rhs=simplify_expr(
+        new_rhs=state.config.simplify(
             member_exprt(
               ssa_rhs,
               components[i].get_name(),
-              components[i].type()),
-            state.config.ns);
+              components[i].type()));
       }
 
       assign_rec(state, guard, operands[i], new_rhs);
@@ -566,12 +644,11 @@ void path_symext::assign_rec(
       {
         exprt new_rhs=
           ssa_rhs.is_nil()?ssa_rhs:
-          simplify_expr(
+          state.config.simplify(
             index_exprt(
               ssa_rhs,
               from_integer(i, index_type()),
-              array_type.subtype()),
-            state.config.ns);
+              array_type.subtype()));
         assign_rec(state, guard, operands[i], new_rhs);
       }
     }
@@ -602,9 +679,9 @@ void path_symext::function_call_symbol(
 
   // find the function
   auto f_it=
-    state.config.goto_functions.function_map.find(function_identifier);
+    state.config.locs.function_map.find(function_identifier);
 
-  if(f_it==state.config.goto_functions.function_map.end())
+  if(f_it==state.config.locs.function_map.end())
     throw
       "failed to find `"+id2string(function_identifier)+"' in function_map";
 
@@ -651,7 +728,7 @@ void path_symext::function_call_symbol(
   }
 
   // do we have a body?
-  if(!function_entry.body_available())
+  if(function_entry.first_loc.is_nil())
   {
     // no body
     state.config.no_body(function_identifier);
@@ -664,6 +741,11 @@ void path_symext::function_call_symbol(
     return;
   }
 
+  // an earlier call with the same concrete inputs?
+  if(state.config.summaries.is_enabled() &&
+     replay_summary(state, call, function_identifier, ssa_arguments))
+    return;
+
   // push a frame on the call stack
   path_symex_statet::threadt &thread=
     state.threads[state.get_current_thread()];
@@ -672,7 +754,22 @@ void path_symext::function_call_symbol(
   thread.call_stack.back().return_location=thread.pc.next_loc();
   thread.call_stack.back().return_lhs=call.lhs();
   thread.call_stack.back().return_rhs=nil_exprt();
-  thread.call_stack.back().hidden_function=function_entry.is_hidden();
+
+  // record the effect of the call, unless it turns out
+  // to depend on values that are not concrete
+  if(state.config.summaries.is_enabled() &&
+     state.summary_recording==nullptr &&
+     function_summariest::is_concrete(ssa_arguments))
+  {
+    state.summary_recording=
+      std::make_shared<path_symex_statet::summary_recordingt>();
+    path_symex_statet::summary_recordingt &recording=
+      *state.summary_recording;
+    recording.function=function_identifier;
+    recording.arguments=ssa_arguments;
+    recording.thread=state.get_current_thread();
+    recording.frame=thread.call_stack.size();
+  }
 
   #if 0
   for(loc_reft l=function_entry_point; ; ++l)
@@ -742,8 +839,10 @@ void path_symext::function_call_symbol(
       // clear the var_state, since the type may have changed
       const symbol_exprt symbol_expr(id, ssa_rhs.type());
       auto &var_info=state.config.var_map(id, irep_idt(), symbol_expr);
-      var_info.original=symbol_expr;
-      state.get_var_state(var_info).ssa_symbol.set_identifier(irep_idt());
+      var_info.set_original(symbol_expr);
+      auto &var_state=state.get_var_state(var_info);
+      var_state.ssa_symbol.set_identifier(irep_idt());
+      state.new_version(var_info, var_state);
 
       va_count++;
 
@@ -763,9 +862,7 @@ void path_symext::function_call_symbol(
   state.recursion_map[function_identifier]++;
 
   // set the new PC
-  assert(!function_entry.body.instructions.empty());
-  thread.pc=
-    loc_reft(function_identifier, function_entry.body.instructions.begin());
+  thread.pc=function_entry.first_loc;
 }
 
 void path_symext::function_call_rec(
@@ -821,6 +918,36 @@ void path_symext::function_call_rec(
     throw "TODO: function_call "+function.id_string();
 }
 
+/// forgets the values of the given local variables of \p function,
+/// unless the function is active more than once, as the frames
+/// share their variables
+static void release_dead(
+  path_symex_statet &state,
+  const irep_idt &function,
+  const livenesst::variablest &variables)
+{
+  const auto r_it=state.recursion_map.find(function);
+  if(r_it!=state.recursion_map.end() && r_it->second>1)
+    return;
+
+  for(const auto &symbol : variables)
+    state.release(symbol);
+}
+
+/// forgets the values of the local variables that die
+/// on the way into the PC of \p state
+static void release_dead(path_symex_statet &state)
+{
+  if(!state.is_executable())
+    return;
+
+  const loct &loc=state.get_loc();
+  release_dead(
+    state,
+    loc.function_identifier,
+    state.config.liveness.dead_on_entry(state.pc()));
+}
+
 void path_symext::return_from_function(path_symex_statet &state)
 {
   path_symex_statet::threadt &thread=state.threads[state.get_current_thread()];
@@ -836,8 +963,13 @@ void path_symext::return_from_function(path_symex_statet &state)
   }
   else
   {
-    // update statistics
-    state.recursion_map[thread.call_stack.back().current_function]--;
+    // the end of a recorded call?
+    if(state.summary_recording &&
+       state.summary_recording->thread==state.get_current_thread() &&
+       state.summary_recording->frame==thread.call_stack.size())
+      finish_summary(state);
+
+    const loc_reft end_function=thread.pc;
 
     // set PC to return location
     thread.pc=thread.call_stack.back().return_location;
@@ -848,6 +980,15 @@ void path_symext::return_from_function(path_symex_statet &state)
       assign(state, thread.call_stack.back().return_lhs,
                     thread.call_stack.back().return_rhs);
 
+    // the variables read by the RETURN are dead now
+    release_dead(
+      state,
+      state.config.locs[end_function].function_identifier,
+      state.config.liveness.dead_on_return(end_function));
+
+    // update statistics
+    state.recursion_map[thread.call_stack.back().current_function]--;
+
     // restore the local variables
     for(path_symex_statet::var_state_mapt::const_iterator
         it=thread.call_stack.back().saved_local_vars.begin();
@@ -860,6 +1001,110 @@ void path_symext::return_from_function(path_symex_statet &state)
   }
 }
 
+/// replays the summary of an earlier call with the same arguments
+/// whose reads have the same values in \p state
+/// \return true if successful
+bool path_symext::replay_summary(
+  path_symex_statet &state,
+  const code_function_callt &call,
+  const irep_idt &function_identifier,
+  const exprt::operandst &ssa_arguments)
+{
+  function_summariest &summaries=state.config.summaries;
+
+  if(!function_summariest::is_concrete(ssa_arguments))
+    return false;
+
+  const function_summariest::summariest *candidates=
+    summaries.find(function_identifier, ssa_arguments);
+
+  if(candidates==nullptr)
+    return false;
+
+  var_mapt &var_map=state.config.var_map;
+
+  for(const auto &summary : *candidates)
+  {
+    bool match=true;
+
+    for(const auto &read : summary.reads)
+      if(state.get_var_state(var_map[read.first]).value!=read.second)
+      {
+        match=false;
+        break;
+      }
+
+    if(!match)
+      continue;
+
+    // an enclosing recorded call depends on these, too
+    for(const auto &read : summary.reads)
+      if(state.summary_recording)
+        state.summary_read(var_map[read.first], read.second);
+
+    for(const auto &write : summary.writes)
+      assign(state, var_map[write.first].original, write.second);
+
+    // a nil return value is nondet
+    if(call.lhs().is_not_nil())
+      assign(state, call.lhs(), summary.return_value);
+
+    summaries.replayed++;
+    state.next_pc();
+    return true;
+  }
+
+  return false;
+}
+
+/// stores the summary of the call that returns now,
+/// if it has only depended on concrete values
+void path_symext::finish_summary(path_symex_statet &state)
+{
+  const path_symex_statet::threadt &thread=
+    state.threads[state.get_current_thread()];
+  const path_symex_statet::framet &frame=thread.call_stack.back();
+
+  // the return value may read further variables
+  exprt return_value=nil_exprt();
+  if(frame.return_rhs.is_not_nil())
+    return_value=state.read(frame.return_rhs);
+
+  std::shared_ptr<path_symex_statet::summary_recordingt> recording;
+  recording.swap(state.summary_recording);
+
+  if(recording==nullptr ||
+     (return_value.is_not_nil() &&
+      !function_summariest::is_concrete(return_value)))
+    return;
+
+  function_summariest::summaryt summary;
+  summary.reads.assign(recording->reads.begin(), recording->reads.end());
+  summary.return_value=return_value;
+
+  const std::string prefix=id2string(recording->function)+"::";
+
+  for(const auto id : recording->writes)
+  {
+    const var_mapt::var_infot &var_info=state.config.var_map[id];
+
+    // the locals of the callee are dead after the return
+    if(var_info.kind==var_mapt::var_infot::PROCEDURE_LOCAL &&
+       has_prefix(id2string(var_info.symbol), prefix))
+      continue;
+
+    const exprt &value=state.get_var_state(var_info).value;
+
+    if(!function_summariest::is_concrete(value))
+      return;
+
+    summary.writes.push_back(std::make_pair(id, value));
+  }
+
+  state.config.summaries.insert(
+    recording->function, recording->arguments, std::move(summary));
+}
+
 void path_symext::set_return_value(
   path_symex_statet &state,
   const exprt &v)
@@ -872,6 +1117,137 @@ void path_symext::set_return_value(
     thread.call_stack.back().return_rhs=v;
 }
 
+/// \return \p value as constant of the bit-vector type \p type,
+///   wrapping around like the arithmetic of that type
+static exprt wrapped_constant(const mp_integer &value, const typet &type)
+{
+  const std::size_t width=to_bitvector_type(type).get_width();
+  const mp_integer modulus=power(2, width);
+
+  mp_integer result=value%modulus;
+
+  if(result<0)
+    result+=modulus;
+
+  if(type.id()==ID_signedbv && result>=modulus/2)
+    result-=modulus;
+
+  return from_integer(result, type);
+}
+
+/// executes all iterations of the loop at the pc at once,
+/// using the closed forms of the updates
+/// \return true if the loop has been accelerated
+bool path_symext::accelerate(path_symex_statet &state)
+{
+  const loop_accelerationt::loopt *loop=
+    state.config.loop_acceleration[state.pc()];
+
+  // other threads might interfere
+  if(loop==nullptr || state.threads.size()!=1)
+    return false;
+
+  const loop_accelerationt::updatet &counter=loop->updates[loop->counter];
+
+  // we need the number of iterations
+  const exprt counter_value=state.read(counter.lhs);
+  const exprt bound_value=state.read(loop->bound);
+
+  mp_integer i, b;
+
+  if(!counter_value.is_constant() ||
+     !bound_value.is_constant() ||
+     to_integer(to_constant_expr(counter_value), i) ||
+     to_integer(to_constant_expr(bound_value), b))
+    return false;
+
+  const mp_integer &step=counter.step;
+  mp_integer iterations;
+
+  if(loop->relation==ID_lt && step>0 && i<b)
+    iterations=(b-i+step-1)/step;
+  else if(loop->relation==ID_le && step>0 && i<=b)
+    iterations=(b-i)/step+1;
+  else if(loop->relation==ID_gt && step<0 && i>b)
+    iterations=(i-b-step-1)/(-step);
+  else if(loop->relation==ID_ge && step<0 && i>=b)
+    iterations=(i-b)/(-step)+1;
+  else if(loop->relation==ID_notequal && i!=b &&
+          (b-i)%step==0 && (b-i)/step>0)
+    iterations=(b-i)/step;
+  else
+    return false;
+
+  // the counter must not wrap around on the way
+  const typet &counter_type=state.config.ns.follow(counter.lhs.type());
+  const std::size_t width=to_bitvector_type(counter_type).get_width();
+  const mp_integer final_value=i+iterations*step;
+
+  if(counter_type.id()==ID_unsignedbv?
+       (final_value<0 || final_value>=power(2, width)):
+       (final_value<-power(2, width-1) || final_value>=power(2, width-1)))
+    return false;
+
+  // the values before the loop
+  std::vector<exprt> initial, increments;
+
+  for(const auto &update : loop->updates)
+  {
+    initial.push_back(state.read(update.lhs));
+    increments.push_back(state.read(update.increment));
+  }
+
+  std::vector<exprt> final_values;
+
+  for(std::size_t u=0; u<loop->updates.size(); u++)
+  {
+    const loop_accelerationt::updatet &update=loop->updates[u];
+    const typet &type=update.lhs.type();
+    const typet &followed_type=state.config.ns.follow(type);
+
+    exprt sum;
+
+    if(update.induction==loop_accelerationt::updatet::no_update)
+    {
+      // x+=e for a loop-invariant e
+      sum=mult_exprt(
+        wrapped_constant(iterations, followed_type), increments[u]);
+    }
+    else
+    {
+      // x+=y, where y+=d, and thus x+=k*y0+d*k*(k-1)/2,
+      // or d*k*(k+1)/2 when y is updated first
+      const std::size_t y=update.induction;
+      const mp_integer triangle=update.induction_first?
+        iterations*(iterations+1)/2:
+        iterations*(iterations-1)/2;
+
+      sum=plus_exprt(
+        mult_exprt(wrapped_constant(iterations, followed_type), initial[y]),
+        mult_exprt(wrapped_constant(triangle, followed_type), increments[y]));
+    }
+
+    sum.type()=type;
+    final_values.push_back(
+      state.config.simplify(plus_exprt(initial[u], sum, type)));
+  }
+
+  for(std::size_t u=0; u<loop->updates.size(); u++)
+  {
+    const exprt ssa_lhs=state.read_no_propagate(loop->updates[u].lhs);
+    exprt::operandst guard;
+    assign_rec(state, guard, ssa_lhs, final_values[u]);
+  }
+
+  state.set_pc(loop->exit);
+
+  state.config.loop_acceleration.accelerated++;
+  state.config.loop_acceleration.saved_iterations+=
+    integer2size_t(iterations);
+
+  return true;
+}
+
 void path_symext::do_goto(
   path_symex_statet &state,
   std::list<path_symex_statet> &further_states)
@@ -881,19 +1257,31 @@ void path_symext::do_goto(
 
   PRECONDITION(instruction.is_goto());
 
-  if(instruction.is_backwards_goto())
+  if(state.get_loc().backwards_goto)
   {
     // we keep a statistic on how many times we execute backwards gotos
-    state.unwinding_map[state.pc()]++;
+    state.increase_unwinding(state.get_loc().loop_index);
   }
 
   exprt ssa_guard=state.read(instruction.get_condition());
 
+  // the bounds known on this path may decide the guard
+  if(!ssa_guard.is_constant())
+  {
+    const tvt decision=state.intervals.decide(ssa_guard, state.config.ns);
+
+    if(decision.is_known())
+    {
+      state.config.decided_branches++;
+      ssa_guard.make_bool(decision.is_true());
+    }
+  }
+
   if(ssa_guard.is_true()) // branch taken always
   {
     state.record_step();
     state.history->branch=stept::BRANCH_TAKEN;
-    state.set_pc(state.pc().get_target());
+    state.set_pc(state.get_branch_target());
     return; // we are done
   }
 
@@ -904,16 +1292,22 @@ void path_symext::do_goto(
     further_states.push_back(state);
     further_states.back().record_step();
     further_states.back().history->branch=stept::BRANCH_TAKEN;
-    further_states.back().set_pc(state.pc().get_target());
+    further_states.back().set_pc(state.get_branch_target());
     further_states.back().history->ssa_guard=ssa_guard;
+    further_states.back().intervals.assume(
+      ssa_guard, true, state.config.ns);
   }
 
-  // branch not taken case
-  exprt negated_ssa_guard=not_exprt(ssa_guard);
+  // branch not taken case, which needs no constraint
+  // when the branch is never taken
+  exprt negated_ssa_guard=ssa_guard.is_false()?
+    static_cast<const exprt &>(true_exprt()):
+    state.config.expr_store(not_exprt(ssa_guard));
   state.record_step();
   state.history->branch=stept::BRANCH_NOT_TAKEN;
   state.next_pc();
   state.history->ssa_guard=negated_ssa_guard;
+  state.intervals.assume(ssa_guard, false, state.config.ns);
 }
 
 void path_symext::do_goto(
@@ -925,10 +1319,10 @@ void path_symext::do_goto(
   const goto_programt::instructiont &instruction=
     *state.get_instruction();
 
-  if(instruction.is_backwards_goto())
+  if(state.get_loc().backwards_goto)
   {
     // we keep a statistic on how many times we execute backwards gotos
-    state.unwinding_map[state.pc()]++;
+    state.increase_unwinding(state.get_loc().loop_index);
   }
 
   exprt ssa_guard=state.read(instruction.get_condition());
@@ -936,7 +1330,7 @@ void path_symext::do_goto(
   if(taken)
   {
     // branch taken case
-    state.set_pc(state.pc().get_target());
+    state.set_pc(state.get_branch_target());
     state.history->ssa_guard=ssa_guard;
     state.history->branch=stept::BRANCH_TAKEN;
   }
@@ -954,20 +1348,25 @@ void path_symext::operator()(
   path_symex_statet &state,
   std::list<path_symex_statet> &further_states)
 {
-  const goto_programt::instructiont &instruction=
-    *state.get_instruction();
+  const loct &loc=state.get_loc();
+  const goto_programt::instructiont &instruction=*loc.target;
 
   #ifdef DEBUG
   std::cout << "path_symext::operator(): "
             << state.pc() << " "
-            << instruction.type
+            << loc.type
             << '\n';
   #endif
 
+  // other threads may run first
+  schedule(state, further_states);
+
   // update some statistics
   state.increase_depth();
 
-  switch(instruction.type)
+  const std::size_t no_further_states=further_states.size();
+
+  switch(loc.type)
   {
   case END_FUNCTION:
     // pop the call stack
@@ -987,26 +1386,34 @@ void path_symext::operator()(
 
   case START_THREAD:
     {
-      auto target = state.pc().get_target();
+      auto target = state.get_branch_target();
 
       state.record_step();
       state.next_pc();
 
+      // we do not summarize calls that spawn threads
+      state.summary_recording.reset();
+
       // ordering of the following matters due to vector instability
       path_symex_statet::threadt &new_thread=state.add_thread();
       path_symex_statet::threadt &old_thread=
         state.threads[state.get_current_thread()];
       new_thread.pc=target;
       new_thread.local_vars=old_thread.local_vars;
+      new_thread.var_fingerprint=old_thread.var_fingerprint;
     }
     break;
 
   case END_THREAD:
     state.record_step();
     state.disable_current_thread();
+    switch_thread(state, further_states);
     break;
 
   case GOTO:
+    if(state.config.loop_acceleration.is_enabled() && accelerate(state))
+      break;
+
     state.increase_no_branches();
     do_goto(state, further_states);
     break;
@@ -1030,15 +1437,39 @@ void path_symext::operator()(
     {
       exprt ssa_guard=state.read(instruction.get_condition());
       state.history->ssa_guard=ssa_guard;
+
+      // a replay would not constrain the path
+      if(state.summary_recording && !ssa_guard.is_true())
+        state.summary_recording.reset();
+
+      if(state.intervals.decide(ssa_guard, state.config.ns).is_false())
+        state.make_infeasible();
+      else
+        state.intervals.assume(ssa_guard, true, state.config.ns);
     }
     break;
 
   case ASSERT:
+    // A replay would not check the assertion, and the recorded
+    // call may have run on an infeasible path.
+    state.summary_recording.reset();
+    state.record_step();
+    state.next_pc();
+    break;
+
   case SKIP:
   case LOCATION:
+    state.record_step();
+    state.next_pc();
+    break;
+
   case DEAD:
     state.record_step();
     state.next_pc();
+    release_dead(
+      state,
+      loc.function_identifier,
+      { instruction.get_dead().symbol().get_identifier() });
     break;
 
   case DECL:
@@ -1165,6 +1596,25 @@ void path_symext::operator()(
   default:
     throw "path_symext: unexpected instruction";
   }
+
+  // we do not summarize calls that fork
+  if(state.summary_recording &&
+     further_states.size()!=no_further_states)
+  {
+    state.summary_recording.reset();
+
+    for(auto it=std::next(further_states.begin(), no_further_states);
+        it!=further_states.end();
+        it++)
+      it->summary_recording.reset();
+  }
+
+  release_dead(state);
+
+  for(auto it=std::next(further_states.begin(), no_further_states);
+      it!=further_states.end();
+      it++)
+    release_dead(*it);
 }
 
 void path_symext::operator()(path_symex_statet &state)
@@ -1197,6 +1647,14 @@ void path_symex_goto(
   path_symex.do_goto(state, taken);
 }
 
+bool path_symex_merge(
+  path_symex_statet &dest,
+  const path_symex_statet &src)
+{
+  path_symext path_symex;
+  return path_symex.merge(dest, src);
+}
+
 void path_symex_assert_fail(path_symex_statet &state)
 {
   path_symext path_symex;
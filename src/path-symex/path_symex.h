@@ -36,6 +36,14 @@ void path_symex_goto(
   path_symex_statet &state,
   bool taken);
 
+// Merges 'src' into 'dest', which must be at the same location
+// with the same call stacks. Returns false, and leaves the
+// values in 'dest' unchanged, when the states do not fit or
+// when the merge is estimated to be too costly.
+bool path_symex_merge(
+  path_symex_statet &dest,
+  const path_symex_statet &src);
+
 // Transforms a state by executing an assertion statement;
 // it is enforced that the assertion fails.
 void path_symex_assert_fail(
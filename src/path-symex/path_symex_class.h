@@ -70,6 +70,30 @@ protected:
     const symbol_exprt &function,
     std::list<path_symex_statet> &further_states);
 
+  bool accelerate(path_symex_statet &state);
+
+  path_symex_statet::footprintt footprint(
+    const path_symex_statet &,
+    unsigned thread);
+
+  void schedule(
+    path_symex_statet &,
+    std::list<path_symex_statet> &further_states);
+
+  void switch_thread(
+    path_symex_statet &,
+    std::list<path_symex_statet> &further_states);
+
+  bool replay_summary(
+    path_symex_statet &,
+    const code_function_callt &,
+    const irep_idt &function_identifier,
+    const exprt::operandst &ssa_arguments);
+
+  void finish_summary(path_symex_statet &);
+
+  bool merge(path_symex_statet &dest, const path_symex_statet &src);
+
   void return_from_function(path_symex_statet &state);
 
   void set_return_value(path_symex_statet &, const exprt &);
@@ -101,6 +125,12 @@ protected:
     assign(state, assignment.lhs(), assignment.rhs());
   }
 
+  exprt copy_source(path_symex_statet &, const exprt &src);
+  bool copy_object(
+    path_symex_statet &,
+    const exprt &dest,
+    const exprt &src);
+
   void assign_rec(
     path_symex_statet &state,
     exprt::operandst &guard, // SSAed
@@ -125,7 +155,16 @@ protected:
     const index_exprt &ssa_lhs, // SSAed, recursion here
     const exprt &ssa_rhs); // SSAed
 
+  static bool propagate(const path_symex_configt &, const exprt &src);
   static bool propagate(const exprt &src);
+  static bool propagate_aggressive(const exprt &src, std::size_t &budget);
+
+  // the maximal number of nodes propagated aggressively
+  static const std::size_t max_propagation_size=64;
+
+  // Merges that change more variables than this are not done.
+  // Variables that lose a constant value count twice.
+  static const std::size_t max_merge_cost=16;
 };
 
 
@@ -23,24 +23,11 @@ void path_symex_configt::no_body(const irep_idt &identifier)
 
 path_symex_statet path_symex_configt::initial_state()
 {
-  const irep_idt entry_function = goto_functionst::entry_point();
-
-  // look that up
-  auto f_it = goto_functions.function_map.find(entry_function);
-  if(f_it == goto_functions.function_map.end())
-    throw "no entry point";
-
-  if(!f_it->second.body_available())
-    throw "no entry point";
-
-  if(f_it->second.body.instructions.empty())
-    throw "no entry point";
-
   path_symex_statet s(*this);
 
   // create one new thread
   path_symex_statet::threadt &thread=s.add_thread();
-  thread.pc=loc_reft(entry_function, f_it->second.body.instructions.begin()); // set its PC
+  thread.pc=locs.first_loc(goto_functionst::entry_point()); // set its PC
 
   if(thread.pc.is_nil())
     throw "no entry point";
@@ -50,3 +37,13 @@ path_symex_statet path_symex_configt::initial_state()
 
   return s;
 }
+
+void path_symex_configt::clear_caches()
+{
+  // the keys of these are canonical in the store,
+  // and their results are shared with it
+  read_cache.clear();
+  simplify.clear();
+  dereference.clear_results();
+  expr_store.clear();
+}
@@ -12,6 +12,13 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_PATH_SYMEX_PATH_SYMEX_CONFIG_H
 #define CPROVER_PATH_SYMEX_PATH_SYMEX_CONFIG_H
 
+#include "expr_store.h"
+#include "function_summaries.h"
+#include "loop_acceleration.h"
+#include "points_to.h"
+#include "read_cache.h"
+#include "simplify_cache.h"
+#include "symex_dereference.h"
 #include "var_map.h"
 #include "path_symex_history.h"
 
@@ -19,10 +26,24 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <goto-programs/goto_functions.h>
 
+#include <goto-locs/liveness.h>
+#include <goto-locs/locs.h>
+
+#include <chrono>
+#include <limits>
 #include <set>
+#include <vector>
 
 struct path_symex_statet;
 
+// which values assigned to variables are propagated into later reads
+enum class propagationt
+{
+  NONE,      // pointers only, as needed for dereferencing
+  SIMPLE,    // constants, symbols, addresses and a few simple forms
+  AGGRESSIVE // also array reads, 'with' chains and arithmetic, bounded
+};
+
 struct path_symex_configt:public messaget
 {
 public:
@@ -31,17 +52,114 @@ public:
     const goto_functionst &_goto_functions):
     ns(_ns),
     goto_functions(_goto_functions),
-    var_map(_ns)
+    decided_branches(0),
+    context_switches(0),
+    pruned_context_switches(0),
+    propagation(propagationt::SIMPLE),
+    fused_read(false),
+    context_bound(std::numeric_limits<unsigned>::max()),
+    time_reads(false),
+    read_time(0),
+    read_depth(0),
+    var_map(_ns),
+    locs(_ns),
+    simplify(_ns, expr_store),
+    dereference(_ns, expr_store, simplify),
+    points_to(_ns),
+    loop_acceleration(_ns)
   {
+    locs.build(goto_functions);
+    liveness.build(locs, _ns);
   }
 
   const namespacet &ns;
   const goto_functionst &goto_functions;
+
+  // statistics: branches decided by the interval domain
+  std::size_t decided_branches;
+
+  // statistics: context switches explored by the scheduler,
+  // and those omitted due to sleep sets
+  std::size_t context_switches, pruned_context_switches;
+
+  propagationt propagation;
+
+  // instantiate and simplify in one traversal
+  bool fused_read;
+
+  // threads are not preempted on paths with this many context switches
+  unsigned context_bound;
+
+  // statistics: time spent in reads, not counting nested ones,
+  // only measured when time_reads is set
+  bool time_reads;
+  std::chrono::duration<double> read_time;
+  std::size_t read_depth;
+
+  // the stack of path_symex_statet::dereference_rec, kept to reuse
+  // its memory; nested reads push above the frames of their caller
+  struct dereference_framet
+  {
+    const exprt *src;
+    std::size_t next_op;
+    bool changed;
+    exprt result;
+
+    explicit dereference_framet(const exprt &_src):
+      src(&_src), next_op(0), changed(false)
+    {
+    }
+  };
+
+  std::vector<dereference_framet> dereference_stack;
+
   var_mapt var_map;
+
+  // the program, as densely numbered locations
+  locst locs;
+
+  // the local variables that die on the way into each location
+  livenesst liveness;
+
   path_symex_historyt path_symex_history;
 
+  // hash-consed results of path_symex_statet::read
+  expr_storet expr_store;
+
+  // memoized results of path_symex_statet::read
+  read_cachet read_cache;
+
+  // memoized results of the simplifier, shared by all states
+  simplify_cachet simplify;
+
+  // remembers object layouts and dereferenced pointers
+  symex_dereferencet dereference;
+
+  // optional, to resolve pointers that are not propagated
+  points_tot points_to;
+
+  // optional, to execute simple counting loops at once
+  loop_accelerationt loop_acceleration;
+
+  // optional, to replay calls that only depend on concrete values
+  function_summariest summaries;
+
   path_symex_statet initial_state();
 
+  // Clears the expression store and the caches whose entries refer
+  // to its expressions. Only to be called between steps, as reads
+  // hold references into the store.
+  void clear_caches();
+
+  // clears the caches if the expression store or the simplifier
+  // cache, whose entries all live in the store, are full
+  void bound_caches()
+  {
+    if(expr_store.size()>=expr_storet::max_size ||
+       simplify.size()>=simplify_cachet::max_size)
+      clear_caches();
+  }
+
 protected:
   std::set<irep_idt> body_warnings;
   void no_body(const irep_idt &);
@@ -0,0 +1,275 @@
+/*******************************************************************\
+
+Module: Copying of Whole Objects
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Copying of Whole Objects
+
+#include "path_symex_class.h"
+
+#include <util/arith_tools.h>
+#include <util/base_type.h>
+#include <util/prefix.h>
+
+/// \return whether objects of the given type are split into
+///   variables that can be copied one by one
+static bool is_copyable(const path_symex_statet &state, const typet &src)
+{
+  const typet &type=state.config.ns.follow(src);
+
+  if(type.id()==ID_struct)
+  {
+    for(const auto &component : to_struct_type(type).components())
+      if(!is_copyable(state, component.type()))
+        return false;
+
+    return true;
+  }
+  else if(type.id()==ID_array &&
+          !state.config.var_map.is_unbounded_array(type))
+  {
+    const array_typet &array_type=to_array_type(type);
+
+    return
+      array_type.size().is_constant() &&
+      is_copyable(state, array_type.subtype());
+  }
+  else if(type.id()==ID_union)
+    return false; // unions are not split
+  else
+    return true;
+}
+
+/// Splits \p src, a variable or a component of one that is selected
+/// with constant indices, into the names of its variable in the
+/// var_mapt, as done by path_symex_statet::read_symbol_member_index.
+/// \return true if \p src has this form
+static bool get_name(
+  const path_symex_statet &state,
+  const exprt &src,
+  irep_idt &identifier,
+  std::string &suffix)
+{
+  suffix="";
+  const exprt *current=&src;
+
+  while(current->id()!=ID_symbol)
+  {
+    if(current->id()==ID_member)
+    {
+      const member_exprt &member_expr=to_member_expr(*current);
+
+      if(state.config.ns.follow(member_expr.struct_op().type()).id()!=
+         ID_struct)
+        return false;
+
+      suffix="."+id2string(member_expr.get_component_name())+suffix;
+      current=&member_expr.struct_op();
+    }
+    else if(current->id()==ID_index)
+    {
+      const index_exprt &index_expr=to_index_expr(*current);
+
+      if(state.config.var_map.is_unbounded_array(index_expr.array().type()))
+        return false;
+
+      const auto index=
+        numeric_cast<mp_integer>(state.config.simplify(index_expr.index()));
+
+      if(!index.has_value())
+        return false;
+
+      suffix="["+integer2string(*index)+"]"+suffix;
+      current=&index_expr.array();
+    }
+    else
+      return false;
+  }
+
+  if(current->get_bool(ID_C_SSA_symbol))
+    return false;
+
+  identifier=to_symbol_expr(*current).get_identifier();
+
+  return !has_prefix(id2string(identifier), "symex::deref");
+}
+
+/// Lets the variable \p dest refer to the state of the variable \p src:
+/// both share the SSA symbol and the value, and no constraint is added.
+static void copy_variable(
+  path_symex_statet &state,
+  const exprt &dest,
+  const irep_idt &dest_identifier,
+  const std::string &dest_suffix,
+  const exprt &src,
+  const irep_idt &src_identifier,
+  const std::string &src_suffix)
+{
+  var_mapt &var_map=state.config.var_map;
+  var_mapt::var_infot &src_info=var_map(src_identifier, src_suffix, src);
+  var_mapt::var_infot &dest_info=var_map(dest_identifier, dest_suffix, dest);
+
+  bool fresh=false;
+
+  // warning: reference var_state is not stable
+  {
+    path_symex_statet::var_statet &var_state=state.get_var_state(src_info);
+
+    if(var_state.ssa_symbol.get_identifier().empty())
+    {
+      // as when reading the variable
+      var_state.ssa_symbol=src_info.ssa_symbol();
+      state.new_version(src_info, var_state);
+      fresh=true;
+    }
+  }
+
+  const exprt value=state.get_var_state(src_info).value;
+  symbol_exprt ssa_symbol=state.get_var_state(src_info).ssa_symbol;
+
+  if(state.summary_recording)
+    state.summary_read(src_info, value);
+
+  if(state.summary_recording)
+    state.summary_write(dest_info);
+
+  // assignments to the copy go to the variable of dest
+  ssa_symbol.set(ID_C_full_identifier, dest_info.full_identifier);
+
+  {
+    path_symex_statet::var_statet &var_state=state.get_var_state(dest_info);
+    var_state.value=value;
+    var_state.ssa_symbol=ssa_symbol;
+    state.new_version(dest_info, var_state);
+  }
+
+  // record the step, for the trace
+  state.record_step();
+  path_symex_stept &step=*state.history;
+
+  step.lhs=dest_info.original;
+  step.ssa_lhs=ssa_symbol;
+
+  // a tautology, added so the solver knows about the symbol
+  if(fresh)
+    step.ssa_rhs=ssa_symbol;
+}
+
+static void copy_rec(
+  path_symex_statet &state,
+  const exprt &dest,
+  const irep_idt &dest_identifier,
+  const std::string &dest_suffix,
+  const exprt &src,
+  const irep_idt &src_identifier,
+  const std::string &src_suffix)
+{
+  const typet &type=state.config.ns.follow(dest.type());
+
+  if(type.id()==ID_struct)
+  {
+    for(const auto &component : to_struct_type(type).components())
+    {
+      const irep_idt &name=component.get_name();
+      const std::string suffix="."+id2string(name);
+
+      copy_rec(
+        state,
+        member_exprt(dest, name, component.type()),
+        dest_identifier,
+        dest_suffix+suffix,
+        member_exprt(src, name, component.type()),
+        src_identifier,
+        src_suffix+suffix);
+    }
+  }
+  else if(type.id()==ID_array &&
+          !state.config.var_map.is_unbounded_array(type))
+  {
+    const array_typet &array_type=to_array_type(type);
+    const auto size=numeric_cast<mp_integer>(array_type.size());
+    CHECK_RETURN(size.has_value());
+
+    for(mp_integer i=0; i<*size; ++i)
+    {
+      const exprt index=from_integer(i, array_type.size().type());
+      const std::string suffix="["+integer2string(i)+"]";
+
+      copy_rec(
+        state,
+        index_exprt(dest, index, array_type.subtype()),
+        dest_identifier,
+        dest_suffix+suffix,
+        index_exprt(src, index, array_type.subtype()),
+        src_identifier,
+        src_suffix+suffix);
+    }
+  }
+  else
+    copy_variable(
+      state,
+      dest, dest_identifier, dest_suffix,
+      src, src_identifier, src_suffix);
+}
+
+/// \return the object that \p src, a struct or array that is not
+///   read whole, denotes, or nil if this is not a single object
+///   that is split into variables
+exprt path_symext::copy_source(
+  path_symex_statet &state,
+  const exprt &src)
+{
+  const typet &type=state.config.ns.follow(src.type());
+
+  if((type.id()!=ID_struct && type.id()!=ID_array) ||
+     (src.id()!=ID_symbol && src.id()!=ID_member &&
+      src.id()!=ID_index && src.id()!=ID_dereference) ||
+     !is_copyable(state, type))
+    return nil_exprt();
+
+  // this resolves the pointers on the way
+  const exprt address=state.read(address_of_exprt(src));
+
+  if(address.id()!=ID_address_of)
+    return nil_exprt();
+
+  const exprt &object=to_address_of_expr(address).object();
+
+  irep_idt identifier;
+  std::string suffix;
+
+  if(!get_name(state, object, identifier, suffix))
+    return nil_exprt();
+
+  return object;
+}
+
+/// Copies the object \p src, as returned by copy_source, into \p dest
+/// by letting each variable of \p dest refer to the SSA symbol and the
+/// value of the corresponding one of \p src, which saves both the
+/// constraints of the assignment and the expansion of the rhs.
+/// \return true if \p dest is not an object that can be copied into
+bool path_symext::copy_object(
+  path_symex_statet &state,
+  const exprt &dest,
+  const exprt &src)
+{
+  irep_idt dest_identifier, src_identifier;
+  std::string dest_suffix, src_suffix;
+
+  if(!get_name(state, dest, dest_identifier, dest_suffix) ||
+     !get_name(state, src, src_identifier, src_suffix) ||
+     !base_type_eq(dest.type(), src.type(), state.config.ns))
+    return true;
+
+  copy_rec(
+    state,
+    dest, dest_identifier, dest_suffix,
+    src, src_identifier, src_suffix);
+
+  return false;
+}
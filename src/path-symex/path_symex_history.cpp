@@ -10,6 +10,7 @@ Author: Daniel Kroening, kroening@kroening.com
 /// History of path-based symbolic simulator
 
 #include "path_symex_history.h"
+#include "var_map.h"
 
 #include <algorithm>
 
@@ -29,23 +30,58 @@ void path_symex_stept::output(std::ostream &out) const
  */
   out << "\n";
 
-  out << "SSA Guard: " << from_expr(ssa_guard) << "\n";
+  out << "SSA Guard: " << from_expr(name_ssa_symbols(ssa_guard)) << "\n";
   out << "LHS: " << from_expr(lhs) << "\n";
-  out << "SSA LHS: " << from_expr(ssa_lhs) << "\n";
-  out << "SSA RHS: " << from_expr(ssa_rhs) << "\n";
+  out << "SSA LHS: " << from_expr(name_ssa_symbols(ssa_lhs)) << "\n";
+  out << "SSA RHS: " << from_expr(name_ssa_symbols(ssa_rhs)) << "\n";
   out << "\n";
 }
 
 void path_symex_stept::convert(decision_proceduret &dest) const
 {
+  // the solver tells symbols apart by their names only
   for(const auto &arg : function_arguments)
-    dest << equal_exprt(arg.ssa_lhs, arg.ssa_rhs);
+    dest << name_ssa_symbols(equal_exprt(arg.ssa_lhs, arg.ssa_rhs));
 
   if(ssa_rhs.is_not_nil())
-    dest << equal_exprt(ssa_lhs, ssa_rhs);
+    dest << name_ssa_symbols(equal_exprt(ssa_lhs, ssa_rhs));
 
   if(ssa_guard.is_not_nil())
-    dest << ssa_guard;
+    dest << name_ssa_symbols(ssa_guard);
+}
+
+void path_symex_stept::convert(exprt::operandst &dest) const
+{
+  for(const auto &arg : function_arguments)
+    dest.push_back(equal_exprt(arg.ssa_lhs, arg.ssa_rhs));
+
+  if(ssa_rhs.is_not_nil())
+    dest.push_back(equal_exprt(ssa_lhs, ssa_rhs));
+
+  if(ssa_guard.is_not_nil())
+    dest.push_back(ssa_guard);
+}
+
+path_symex_step_reft path_symex_step_reft::common_ancestor(
+  path_symex_step_reft other) const
+{
+  path_symex_step_reft s=*this;
+
+  // the predecessors are created first, and thus have smaller indices
+  while(s!=other)
+  {
+    if(s.is_nil())
+      return s;
+    else if(other.is_nil())
+      return other;
+
+    if(s.index>other.index)
+      --s;
+    else
+      --other;
+  }
+
+  return s;
 }
 
 void path_symex_step_reft::build_history(
@@ -63,3 +99,31 @@ void path_symex_step_reft::build_history(
   // the above goes backwards: now need to reverse
   std::reverse(dest.begin(), dest.end());
 }
+
+void path_symex_step_reft::build_history(
+  std::vector<path_symex_step_reft> &dest,
+  const decision_proceduret &decision_procedure) const
+{
+  dest.clear();
+
+  path_symex_step_reft s=*this;
+  while(!s.is_nil())
+  {
+    if(s->is_merge())
+    {
+      // continue on the path that was taken
+      const path_symex_stept &step=*s;
+      if(decision_procedure.get(name_ssa_symbols(step.ssa_lhs)).is_true())
+        s=step.merged_first;
+      else
+        s=step.merged_second;
+    }
+    else
+    {
+      dest.push_back(s);
+      --s;
+    }
+  }
+
+  std::reverse(dest.begin(), dest.end());
+}
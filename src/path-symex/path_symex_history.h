@@ -17,9 +17,10 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/base_exceptions.h>
 #include <util/std_expr.h>
 
-#include "loc_ref.h"
+#include <goto-locs/loc_ref.h>
 
 class path_symex_stept;
+class decision_proceduret;
 
 // This is a reference to a path_symex_stept,
 // and is really cheap to copy. These references are stable,
@@ -57,11 +58,30 @@ public:
   path_symex_stept &operator*() const { return get(); }
   path_symex_stept *operator->() const { return &get(); }
 
+  bool operator==(const path_symex_step_reft &other) const
+  {
+    return index==other.index;
+  }
+
+  bool operator!=(const path_symex_step_reft &other) const
+  {
+    return index!=other.index;
+  }
+
   void generate_successor();
 
+  // the last step the two histories have in common, possibly nil
+  path_symex_step_reft common_ancestor(path_symex_step_reft other) const;
+
   // build a forward-traversable version of the history
   void build_history(std::vector<path_symex_step_reft> &dest) const;
 
+  // as above, but follows the paths of merges
+  // that the solution of the decision procedure takes
+  void build_history(
+    std::vector<path_symex_step_reft> &dest,
+    const decision_proceduret &) const;
+
 protected:
   // we use a vector to store all steps
   std::size_t index;
@@ -70,15 +90,13 @@ protected:
   path_symex_stept &get() const;
 };
 
-class decision_proceduret;
-
 // the actual history node
 class path_symex_stept
 {
 public:
   enum kindt
   {
-    NON_BRANCH, BRANCH_TAKEN, BRANCH_NOT_TAKEN
+    NON_BRANCH, BRANCH_TAKEN, BRANCH_NOT_TAKEN, MERGE
   } branch;
 
   bool is_branch_taken() const
@@ -96,6 +114,11 @@ public:
     return branch==BRANCH_TAKEN || branch==BRANCH_NOT_TAKEN;
   }
 
+  bool is_merge() const
+  {
+    return branch==MERGE;
+  }
+
   path_symex_step_reft predecessor;
 
   // the thread that did the step
@@ -114,6 +137,16 @@ public:
 
   bool hidden;
 
+  // the sum of the hashes of the ssa_guards of the predecessors,
+  // see path_symex_statet::fingerprint
+  std::size_t constraint_hash;
+
+  // For merges: the two paths that were merged, which both
+  // lead back to the predecessor. The ssa_lhs is the symbol that
+  // selects the first path, and the ssa_guard is the disjunction
+  // of the paths.
+  path_symex_step_reft merged_first, merged_second;
+
   // for function call
   irep_idt called_function;
   struct function_argumentt
@@ -123,6 +156,7 @@ public:
     {
     }
   };
+  // also used for the values defined by merges
   std::vector<function_argumentt> function_arguments;
 
   path_symex_stept():
@@ -132,13 +166,17 @@ public:
     ssa_guard(nil_exprt()),
     ssa_lhs(symbol_exprt(irep_idt(), typet())),
     ssa_rhs(nil_exprt()),
-    hidden(false)
+    hidden(false),
+    constraint_hash(0)
   {
   }
 
   // interface to solvers; this converts a single step
   void convert(decision_proceduret &dest) const;
 
+  // as above, but collects the constraints
+  void convert(exprt::operandst &dest) const;
+
   void output(std::ostream &) const;
 };
 
@@ -168,6 +206,13 @@ public:
   {
     step_container.clear();
   }
+
+  // approximate number of bytes, not counting the
+  // expressions, which are shared
+  std::size_t approx_memory() const
+  {
+    return step_container.capacity()*sizeof(path_symex_stept);
+  }
 };
 
 inline void path_symex_step_reft::generate_successor()
@@ -0,0 +1,249 @@
+/*******************************************************************\
+
+Module: Merging of States
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Merging of States
+
+#include "path_symex_class.h"
+
+#include <algorithm>
+
+#include <util/symbol.h>
+
+static bool is_small(const exprt &src, std::size_t &budget)
+{
+  if(budget==0)
+    return false;
+
+  budget--;
+
+  forall_operands(it, src)
+    if(!is_small(*it, budget))
+      return false;
+
+  return true;
+}
+
+/// Merges the state \p src into \p dest. The path constraint becomes
+/// a disjunction of the two paths since their last common step, and
+/// the variables that differ are given new SSA symbols, defined as
+/// if-expressions over a fresh symbol that selects the path of \p dest.
+bool path_symext::merge(
+  path_symex_statet &dest,
+  const path_symex_statet &src)
+{
+  typedef path_symex_statet::var_statet var_statet;
+
+  if(!dest.is_active() || !src.is_active() ||
+     !dest.same_control(src))
+    return false;
+
+  // variables that src has never touched
+  static const var_statet untouched;
+
+  // collect the variables that differ
+  std::vector<std::pair<var_statet *, const var_statet *>> vars;
+
+  auto collect=[&vars](
+    path_symex_statet::var_valt &dest_vars,
+    const path_symex_statet::var_valt &src_vars)
+  {
+    if(dest_vars.size()<src_vars.size())
+      dest_vars.resize(src_vars.size());
+
+    for(std::size_t i=0; i<dest_vars.size(); i++)
+    {
+      const var_statet &src_var=i<src_vars.size()?src_vars[i]:untouched;
+
+      if(dest_vars[i].value!=src_var.value ||
+         ssa_key(dest_vars[i].ssa_symbol)!=ssa_key(src_var.ssa_symbol))
+        vars.push_back(std::make_pair(&dest_vars[i], &src_var));
+    }
+  };
+
+  collect(dest.shared_vars, src.shared_vars);
+
+  for(std::size_t t=0; t<dest.threads.size(); t++)
+  {
+    path_symex_statet::threadt &dest_thread=dest.threads[t];
+    const path_symex_statet::threadt &src_thread=src.threads[t];
+
+    collect(dest_thread.local_vars, src_thread.local_vars);
+
+    for(std::size_t f=0; f<dest_thread.call_stack.size(); f++)
+    {
+      auto &dest_saved=dest_thread.call_stack[f].saved_local_vars;
+      const auto &src_saved=src_thread.call_stack[f].saved_local_vars;
+
+      // the keys are the same, see same_control
+      auto s_it=src_saved.begin();
+      for(auto &entry : dest_saved)
+      {
+        if(entry.second.value!=s_it->second.value ||
+           ssa_key(entry.second.ssa_symbol)!=
+             ssa_key(s_it->second.ssa_symbol))
+          vars.push_back(std::make_pair(&entry.second, &s_it->second));
+        ++s_it;
+      }
+    }
+  }
+
+  // The cost heuristic: each new SSA symbol makes the later
+  // queries bigger, and a variable that loses its constant value
+  // may make branches undecidable without the solver.
+  std::size_t cost=0;
+
+  for(const auto &v : vars)
+  {
+    cost++;
+    if(v.first->value.is_constant() && v.second->value.is_constant())
+      cost++;
+  }
+
+  if(cost>max_merge_cost)
+    return false;
+
+  path_symex_configt &config=dest.config;
+
+  // the symbol that selects the path of dest
+  irep_idt guard_id="symex::merge"+std::to_string(config.var_map.nondet_count);
+  config.var_map.nondet_count++;
+
+  auxiliary_symbolt guard_symbol;
+  guard_symbol.name=guard_id;
+  guard_symbol.base_name=guard_id;
+  guard_symbol.type=bool_typet();
+  config.var_map.new_symbols.add(guard_symbol);
+
+  const symbol_exprt guard=guard_symbol.symbol_expr();
+
+  // the constraints of the two paths since they have split
+  const path_symex_step_reft base=dest.history.common_ancestor(src.history);
+  exprt::operandst dest_constraints, src_constraints;
+
+  for(path_symex_step_reft s=dest.history; s!=base; --s)
+    s->convert(dest_constraints);
+
+  for(path_symex_step_reft s=src.history; s!=base; --s)
+    s->convert(src_constraints);
+
+  // the new values
+  std::vector<path_symex_stept::function_argumentt> definitions;
+  std::vector<std::pair<symbol_exprt, intervalt>> intervals;
+
+  for(const auto &v : vars)
+  {
+    var_statet &dest_var=*v.first;
+    const var_statet &src_var=*v.second;
+
+    var_mapt::var_infot &var_info=config.var_map.from_ssa(
+      dest_var.ssa_symbol.get_identifier().empty()?
+        src_var.ssa_symbol:dest_var.ssa_symbol);
+
+    // a side that has never read the variable gets a fresh symbol
+    auto ssa_symbol=[&var_info](const var_statet &var) -> symbol_exprt
+    {
+      if(!var.ssa_symbol.get_identifier().empty())
+        return var.ssa_symbol;
+      var_info.increment_ssa_counter();
+      return var_info.ssa_symbol();
+    };
+
+    const symbol_exprt dest_ssa=ssa_symbol(dest_var);
+    const symbol_exprt src_ssa=ssa_symbol(src_var);
+
+    intervalt interval=dest.intervals.eval(
+      dest_var.value.is_nil()?exprt(dest_ssa):dest_var.value, config.ns);
+    interval.join(src.intervals.eval(
+      src_var.value.is_nil()?exprt(src_ssa):src_var.value, config.ns));
+
+    var_info.increment_ssa_counter();
+    const symbol_exprt new_ssa=var_info.ssa_symbol();
+
+    definitions.push_back(path_symex_stept::function_argumentt());
+    definitions.back().ssa_lhs=new_ssa;
+    definitions.back().ssa_rhs=if_exprt(guard, dest_ssa, src_ssa);
+
+    intervals.push_back(std::make_pair(new_ssa, interval));
+
+    // we keep propagating, as long as the value stays small
+    exprt value=nil_exprt();
+
+    if(dest_var.value.is_not_nil() && src_var.value.is_not_nil())
+    {
+      if(dest_var.value==src_var.value)
+        value=dest_var.value;
+      else
+      {
+        value=if_exprt(guard, dest_var.value, src_var.value);
+        std::size_t budget=max_propagation_size;
+        if(!propagate(config, value) || !is_small(value, budget))
+          value=nil_exprt();
+      }
+    }
+
+    dest_var.value=value;
+    dest_var.ssa_symbol=new_ssa;
+    dest.new_version(var_info, dest_var);
+  }
+
+  // the variables may belong to other threads
+  dest.rehash();
+
+  dest.intervals.join(src.intervals);
+
+  for(const auto &i : intervals)
+    dest.intervals.assign(i.first, i.second, config.ns);
+
+  // the bounds count the longer path
+  if(dest.unwindings.size()<src.unwindings.size())
+    dest.unwindings.resize(src.unwindings.size(), 0);
+
+  for(std::size_t l=0; l<src.unwindings.size(); l++)
+    dest.unwindings[l]=std::max(dest.unwindings[l], src.unwindings[l]);
+
+  for(const auto &r : src.recursion_map)
+  {
+    unsigned &count=dest.recursion_map[r.first];
+    count=std::max(count, r.second);
+  }
+
+  // the recorded reads only hold on the path of dest
+  dest.summary_recording.reset();
+
+  // a thread may only sleep if it does so on both paths
+  for(auto it=dest.sleep_set.begin(); it!=dest.sleep_set.end(); )
+  {
+    if(src.sleep_set.find(it->first)==src.sleep_set.end())
+      it=dest.sleep_set.erase(it);
+    else
+      ++it;
+  }
+
+  dest.depth=std::max(dest.depth, src.depth);
+  dest.no_branches=std::max(dest.no_branches, src.no_branches);
+  dest.no_thread_interleavings=
+    std::max(dest.no_thread_interleavings, src.no_thread_interleavings);
+
+  // record the merge, which continues the common history
+  const path_symex_step_reft dest_history=dest.history;
+  dest.history=base;
+  dest.record_step();
+
+  stept &step=*dest.history;
+  step.branch=stept::MERGE;
+  step.hidden=true;
+  step.ssa_lhs=guard;
+  step.ssa_guard=if_exprt(
+    guard, conjunction(dest_constraints), conjunction(src_constraints));
+  step.merged_first=dest_history;
+  step.merged_second=src.history;
+  step.function_arguments.swap(definitions);
+
+  return true;
+}
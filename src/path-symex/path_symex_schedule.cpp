@@ -0,0 +1,252 @@
+/*******************************************************************\
+
+Module: Thread Scheduling
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Thread Scheduling
+
+#include "path_symex_class.h"
+
+#include <limits>
+
+typedef path_symex_statet::footprintt footprintt;
+
+/// adds the shared objects that \p src may access to \p dest,
+/// as written when \p write is set
+static void get_footprint(
+  const exprt &src,
+  bool write,
+  var_mapt &var_map,
+  footprintt &dest)
+{
+  if(src.id()==ID_dereference)
+    dest.any=true;
+  else if(src.id()==ID_symbol)
+  {
+    // functions are not objects
+    if(src.type().id()==ID_code)
+      return;
+
+    const irep_idt &identifier=to_symbol_expr(src).get_identifier();
+
+    if(!var_map(identifier, irep_idt(), src).is_shared())
+      return;
+
+    if(write)
+      dest.writes.insert(identifier);
+    else
+      dest.reads.insert(identifier);
+  }
+  else if(write && src.id()==ID_index && src.operands().size()==2)
+  {
+    get_footprint(src.op0(), true, var_map, dest);
+    get_footprint(src.op1(), false, var_map, dest);
+  }
+  else
+  {
+    // when writing, we conservatively take the other
+    // operands as written, too
+    forall_operands(it, src)
+      get_footprint(*it, write, var_map, dest);
+  }
+}
+
+/// \return whether the order of instructions with
+///   the given footprints matters
+static bool dependent(const footprintt &a, const footprintt &b)
+{
+  if(a.any || b.any)
+    return true;
+
+  for(const auto &w : a.writes)
+    if(b.writes.find(w)!=b.writes.end() ||
+       b.reads.find(w)!=b.reads.end())
+      return true;
+
+  for(const auto &w : b.writes)
+    if(a.reads.find(w)!=a.reads.end())
+      return true;
+
+  return false;
+}
+
+/// \return the footprint of the next instruction of the given thread;
+///   the instructions with non-empty footprints are those at which
+///   the scheduler switches threads
+path_symex_statet::footprintt path_symext::footprint(
+  const path_symex_statet &state,
+  unsigned thread)
+{
+  const path_symex_statet::threadt &t=state.threads[thread];
+  const loct &loc=state.config.locs[t.pc];
+  const goto_programt::instructiont &instruction=*loc.target;
+  var_mapt &var_map=state.config.var_map;
+
+  footprintt result;
+
+  switch(loc.type)
+  {
+  case ATOMIC_BEGIN:
+    result.any=true;
+    break;
+
+  case END_FUNCTION:
+    // the end of the main thread ends all threads
+    result.any=thread==0 && t.call_stack.empty();
+    break;
+
+  case ASSIGN:
+    {
+      const code_assignt &code_assign=to_code_assign(instruction.code);
+      get_footprint(code_assign.lhs(), true, var_map, result);
+      get_footprint(code_assign.rhs(), false, var_map, result);
+    }
+    break;
+
+  case FUNCTION_CALL:
+    {
+      const code_function_callt &call=to_code_function_call(instruction.code);
+      get_footprint(call.lhs(), true, var_map, result);
+      get_footprint(call.function(), false, var_map, result);
+      for(const auto &argument : call.arguments())
+        get_footprint(argument, false, var_map, result);
+    }
+    break;
+
+  case DECL:
+  case OTHER:
+    // may modify its operands
+    get_footprint(instruction.code, true, var_map, result);
+    break;
+
+  case RETURN:
+  case GOTO:
+  case ASSUME:
+  case ASSERT:
+    get_footprint(instruction.code, false, var_map, result);
+    get_footprint(instruction.guard, false, var_map, result);
+    break;
+
+  default:
+    break;
+  }
+
+  return result;
+}
+
+/// Sleep sets assume that all interleavings are explored. With a
+/// context bound, the one interleaving left may be pruned.
+static bool use_sleep_sets(const path_symex_configt &config)
+{
+  return config.context_bound==std::numeric_limits<unsigned>::max();
+}
+
+/// Forks \p state for each other thread that may run before the
+/// instruction at the PC, unless the switch would exceed the
+/// context bound. A thread that is switched to puts the threads
+/// explored before it to sleep.
+void path_symext::schedule(
+  path_symex_statet &state,
+  std::list<path_symex_statet> &further_states)
+{
+  if(state.threads.size()<2)
+    return;
+
+  const unsigned current_thread=state.get_current_thread();
+  const footprintt current=footprint(state, current_thread);
+
+  // no switching back before the thread has done anything
+  if(!state.scheduled &&
+     !state.inside_atomic_section &&
+     state.get_no_thread_interleavings()<state.config.context_bound &&
+     !current.empty())
+  {
+    path_symex_statet::sleep_sett sleep_set=state.sleep_set;
+    if(use_sleep_sets(state.config))
+      sleep_set[current_thread]=current;
+
+    for(unsigned t=0; t<state.threads.size(); t++)
+    {
+      if(t==current_thread || !state.threads[t].active)
+        continue;
+
+      if(state.sleep_set.find(t)!=state.sleep_set.end())
+      {
+        state.config.pruned_context_switches++;
+        continue;
+      }
+
+      further_states.push_back(state);
+      path_symex_statet &new_state=further_states.back();
+      new_state.set_current_thread(t);
+      new_state.scheduled=true;
+      new_state.sleep_set=sleep_set;
+
+      // the other thread may change what the call has read
+      new_state.summary_recording.reset();
+
+      state.config.context_switches++;
+      if(use_sleep_sets(state.config))
+        sleep_set[t]=footprint(state, t);
+    }
+  }
+
+  state.scheduled=false;
+
+  // the instruction wakes up the threads that depend on it
+  if(!current.empty())
+  {
+    for(auto it=state.sleep_set.begin(); it!=state.sleep_set.end(); )
+    {
+      if(dependent(it->second, current))
+        it=state.sleep_set.erase(it);
+      else
+        ++it;
+    }
+  }
+}
+
+/// Continues with each of the other threads that are not
+/// asleep once the current one has ended. If all of them are
+/// asleep, the current thread stays the ended one, and the state
+/// is no longer executable.
+void path_symext::switch_thread(
+  path_symex_statet &state,
+  std::list<path_symex_statet> &further_states)
+{
+  const unsigned current_thread=state.get_current_thread();
+  path_symex_statet::sleep_sett sleep_set=state.sleep_set;
+  bool first=true;
+
+  for(unsigned t=0; t<state.threads.size(); t++)
+  {
+    if(t==current_thread || !state.threads[t].active)
+      continue;
+
+    if(sleep_set.find(t)!=sleep_set.end())
+    {
+      state.config.pruned_context_switches++;
+      continue;
+    }
+
+    if(first)
+    {
+      state.set_current_thread(t);
+      state.scheduled=true;
+      first=false;
+    }
+    else
+    {
+      further_states.push_back(state);
+      further_states.back().set_current_thread(t);
+      further_states.back().sleep_set=sleep_set;
+    }
+
+    if(use_sleep_sets(state.config))
+      sleep_set[t]=footprint(state, t);
+  }
+}
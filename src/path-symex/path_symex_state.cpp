@@ -11,8 +11,11 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "path_symex_state.h"
 
+#include <algorithm>
+
 #include <util/arith_tools.h>
 #include <util/c_types.h>
+#include <util/irep_hash.h>
 #include <solvers/decision_procedure.h>
 
 #include <langapi/language_util.h>
@@ -37,9 +40,9 @@ void path_symex_statet::output(std::ostream &out) const
   for(const auto &v : shared_vars)
     if(!v.ssa_symbol.get_identifier().empty())
     {
-      out << from_expr(v.ssa_symbol);
+      out << from_expr(name_ssa_symbols(v.ssa_symbol));
       if(v.value.is_not_nil())
-        out << " = " << from_expr(v.value);
+        out << " = " << from_expr(name_ssa_symbols(v.value));
       out << '\n';
     }
 
@@ -51,6 +54,35 @@ void path_symex_statet::output(std::ostream &out) const
   }
 }
 
+std::size_t path_symex_statet::approx_memory() const
+{
+  // rough size of a node of a std::map
+  const std::size_t map_node=4*sizeof(void *);
+
+  std::size_t result=sizeof(path_symex_statet);
+
+  result+=shared_vars.capacity()*sizeof(var_statet);
+  result+=threads.capacity()*sizeof(threadt);
+
+  for(const auto &thread : threads)
+  {
+    result+=thread.local_vars.capacity()*sizeof(var_statet);
+    result+=thread.call_stack.capacity()*sizeof(framet);
+
+    for(const auto &frame : thread.call_stack)
+      result+=frame.saved_local_vars.size()*
+              (map_node+sizeof(var_state_mapt::value_type));
+  }
+
+  result+=unwindings.capacity()*sizeof(unsigned);
+  result+=recursion_map.size()*
+          (map_node+sizeof(recursion_mapt::value_type));
+  result+=intervals.size()*
+          (map_node+sizeof(interval_domaint::mapt::value_type));
+
+  return result;
+}
+
 path_symex_statet::var_statet &path_symex_statet::get_var_state(
   const var_mapt::var_infot &var_info)
 {
@@ -63,6 +95,255 @@ path_symex_statet::var_statet &path_symex_statet::get_var_state(
   return var_val[var_info.number];
 }
 
+void path_symex_statet::summary_read(
+  const var_mapt::var_infot &var_info,
+  const exprt &value)
+{
+  PRECONDITION(summary_recording!=nullptr);
+
+  if(summary_recording->thread!=current_thread ||
+     !function_summariest::is_concrete(value))
+    summary_recording.reset();
+  else if(summary_recording->writes.find(var_info.id)==
+          summary_recording->writes.end())
+    summary_recording->reads.emplace(var_info.id, value);
+}
+
+void path_symex_statet::summary_write(const var_mapt::var_infot &var_info)
+{
+  PRECONDITION(summary_recording!=nullptr);
+
+  if(summary_recording->thread!=current_thread)
+    summary_recording.reset();
+  else
+    summary_recording->writes.insert(var_info.id);
+}
+
+/// \return the sum of the hashes of the constraints up to
+///   and including \p step, irrespective of their order
+static std::size_t constraint_hash(const path_symex_stept &step)
+{
+  if(step.ssa_guard.is_nil() || step.ssa_guard.is_true())
+    return step.constraint_hash;
+  else
+    return step.constraint_hash+irep_hash()(step.ssa_guard);
+}
+
+void path_symex_statet::new_version(
+  const var_mapt::var_infot &var_info,
+  var_statet &var_state)
+{
+  var_state.version=config.read_cache.new_version();
+
+  // the SSA symbol only matters when there is no value,
+  // and a released variable is like one never written
+  const std::size_t hash=
+    var_state.value.is_nil() &&
+    var_state.ssa_symbol.get_identifier().empty()?0:
+    hash_combine(
+      var_info.id,
+      var_state.value.is_not_nil()?
+        irep_hash()(var_state.value):
+        hash_combine(
+          irep_id_hash()(var_state.ssa_symbol.get_identifier()),
+          irep_id_hash()(var_state.ssa_symbol.get(ID_L2))));
+
+  std::size_t &fingerprint=
+    var_info.is_shared()?
+      var_fingerprint:threads[current_thread].var_fingerprint;
+
+  fingerprint+=hash-var_state.hash;
+  var_state.hash=hash;
+}
+
+/// Dead variables are reset to the state of variables never
+/// written, such that states differing only in them are alike.
+void path_symex_statet::release(const irep_idt &symbol)
+{
+  assert(current_thread<threads.size());
+
+  for(const auto id : config.var_map.of_symbol(symbol))
+  {
+    var_mapt::var_infot &var_info=config.var_map[id];
+
+    var_valt &var_val=
+      var_info.is_shared()?shared_vars:threads[current_thread].local_vars;
+    if(var_val.size()<=var_info.number)
+      continue;
+
+    var_statet &var_state=var_val[var_info.number];
+    if(var_state.value.is_nil() &&
+       var_state.ssa_symbol.get_identifier().empty())
+      continue;
+
+    var_state.value.make_nil();
+    var_state.ssa_symbol.set_identifier(irep_idt());
+    new_version(var_info, var_state);
+
+    // a later read must not see the constraints on the last SSA symbol
+    var_info.increment_ssa_counter();
+  }
+}
+
+void path_symex_statet::rehash()
+{
+  var_fingerprint=0;
+  for(const auto &var_state : shared_vars)
+    var_fingerprint+=var_state.hash;
+
+  for(auto &thread : threads)
+  {
+    thread.var_fingerprint=0;
+    for(const auto &var_state : thread.local_vars)
+      thread.var_fingerprint+=var_state.hash;
+  }
+}
+
+std::size_t path_symex_statet::fingerprint() const
+{
+  std::size_t result=hash_combine(current_thread, var_fingerprint);
+  result=hash_combine(result, inside_atomic_section);
+  result=hash_combine(result, scheduled);
+
+  for(const auto &thread : threads)
+  {
+    result=hash_combine(result, thread.pc.loc_number);
+    result=hash_combine(result, thread.active);
+    result=hash_combine(result, thread.var_fingerprint);
+
+    for(const auto &frame : thread.call_stack)
+    {
+      result=hash_combine(result, frame.return_location.loc_number);
+      result=hash_combine(result, irep_hash()(frame.return_lhs));
+      result=hash_combine(result, irep_hash()(frame.return_rhs));
+    }
+  }
+
+  for(const auto &sleeping : sleep_set)
+    result=hash_combine(result, sleeping.first);
+
+  if(!history.is_nil())
+    result=hash_combine(result, constraint_hash(*history));
+
+  return result;
+}
+
+/// \return whether the variables are alike, in the sense of
+///   path_symex_statet::new_version, where untouched ones are
+///   missing from the end
+static bool same_vars(
+  const path_symex_statet::var_valt &a,
+  const path_symex_statet::var_valt &b)
+{
+  static const path_symex_statet::var_statet untouched;
+
+  for(std::size_t i=0; i<a.size() || i<b.size(); i++)
+  {
+    const path_symex_statet::var_statet &var_a=i<a.size()?a[i]:untouched;
+    const path_symex_statet::var_statet &var_b=i<b.size()?b[i]:untouched;
+
+    if(var_a.value!=var_b.value ||
+       (var_a.value.is_nil() &&
+        ssa_key(var_a.ssa_symbol)!=ssa_key(var_b.ssa_symbol)))
+      return false;
+  }
+
+  return true;
+}
+
+/// collects the guards, as hashed by constraint_hash, of the steps
+/// from \p step back to \p stop, exclusively, in a canonical order
+static void get_guards(
+  path_symex_step_reft step,
+  const path_symex_step_reft &stop,
+  exprt::operandst &dest)
+{
+  for(; step!=stop; --step)
+    if(step->ssa_guard.is_not_nil() && !step->ssa_guard.is_true())
+      dest.push_back(step->ssa_guard);
+
+  std::sort(dest.begin(), dest.end());
+}
+
+bool path_symex_statet::same_as(const path_symex_statet &other) const
+{
+  if(!same_control(other) ||
+     !same_vars(shared_vars, other.shared_vars))
+    return false;
+
+  for(std::size_t t=0; t<threads.size(); t++)
+    if(!same_vars(threads[t].local_vars, other.threads[t].local_vars))
+      return false;
+
+  if(sleep_set.size()!=other.sleep_set.size() ||
+     !std::equal(
+       sleep_set.begin(),
+       sleep_set.end(),
+       other.sleep_set.begin(),
+       [](const sleep_sett::value_type &x, const sleep_sett::value_type &y)
+       {
+         return x.first==y.first;
+       }))
+    return false;
+
+  // the constraints before the last common step are shared
+  const path_symex_step_reft common=history.common_ancestor(other.history);
+
+  exprt::operandst guards, other_guards;
+  get_guards(history, common, guards);
+  get_guards(other.history, common, other_guards);
+
+  return guards==other_guards;
+}
+
+bool path_symex_statet::same_control(const path_symex_statet &other) const
+{
+  if(current_thread!=other.current_thread ||
+     inside_atomic_section!=other.inside_atomic_section ||
+     scheduled!=other.scheduled ||
+     threads.size()!=other.threads.size())
+    return false;
+
+  for(std::size_t t=0; t<threads.size(); t++)
+  {
+    const threadt &thread_a=threads[t];
+    const threadt &thread_b=other.threads[t];
+
+    if(thread_a.pc!=thread_b.pc ||
+       thread_a.active!=thread_b.active ||
+       thread_a.call_stack.size()!=thread_b.call_stack.size())
+      return false;
+
+    for(std::size_t f=0; f<thread_a.call_stack.size(); f++)
+    {
+      const framet &frame_a=thread_a.call_stack[f];
+      const framet &frame_b=thread_b.call_stack[f];
+
+      if(frame_a.current_function!=frame_b.current_function ||
+         frame_a.return_location!=frame_b.return_location ||
+         frame_a.return_lhs!=frame_b.return_lhs ||
+         frame_a.return_rhs!=frame_b.return_rhs)
+        return false;
+
+      // the same variables must be restored on return
+      if(frame_a.saved_local_vars.size()!=frame_b.saved_local_vars.size() ||
+         !std::equal(
+           frame_a.saved_local_vars.begin(),
+           frame_a.saved_local_vars.end(),
+           frame_b.saved_local_vars.begin(),
+           [](
+             const var_state_mapt::value_type &x,
+             const var_state_mapt::value_type &y)
+           {
+             return x.first==y.first;
+           }))
+        return false;
+    }
+  }
+
+  return true;
+}
+
 void path_symex_statet::record_step()
 {
   // is there a context switch happening?
@@ -70,9 +351,13 @@ void path_symex_statet::record_step()
      history->thread_nr!=current_thread)
     no_thread_interleavings++;
 
+  // the previous step is complete now
+  const std::size_t hash=history.is_nil()?0:constraint_hash(*history);
+
   // add the step
   history.generate_successor();
   stept &step=*history;
+  step.constraint_hash=hash;
 
   // copy PC
   assert(current_thread<threads.size());
@@ -123,7 +408,7 @@ bool path_symex_statet::check_assertion(
   decision_procedure << history;
 
   // negate the assertion
-  decision_procedure.set_to(assertion, false);
+  decision_procedure.set_to(name_ssa_symbols(assertion), false);
 
   // check whether SAT
   switch(decision_procedure())
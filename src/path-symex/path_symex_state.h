@@ -12,9 +12,13 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_PATH_SYMEX_PATH_SYMEX_STATE_H
 #define CPROVER_PATH_SYMEX_PATH_SYMEX_STATE_H
 
-#include <util/cprover_prefix.h>
+#include <map>
+#include <memory>
+#include <set>
 
-#include "loc_ref.h"
+#include <goto-locs/loc_ref.h>
+
+#include "interval_domain.h"
 #include "path_symex_config.h"
 
 struct path_symex_statet
@@ -22,7 +26,9 @@ struct path_symex_statet
 public:
   explicit path_symex_statet(path_symex_configt &_config):
     config(_config),
+    var_fingerprint(0),
     inside_atomic_section(false),
+    scheduled(false),
     status(statust::ACTIVE),
     current_thread(0),
     no_thread_interleavings(0),
@@ -42,6 +48,13 @@ public:
     exprt value;
     symbol_exprt ssa_symbol;
 
+    // changes whenever value or ssa_symbol change,
+    // see read_cachet
+    std::size_t version;
+
+    // the contribution to the fingerprint of the state
+    std::size_t hash;
+
     // for uninterpreted functions or arrays we maintain an index set
     #if 0
     typedef std::set<exprt> index_sett;
@@ -50,7 +63,9 @@ public:
 
     var_statet():
       value(nil_exprt()),
-      ssa_symbol(irep_idt(), typet())
+      ssa_symbol(irep_idt(), typet()),
+      version(0),
+      hash(0)
     {
     }
   };
@@ -66,15 +81,10 @@ public:
   struct framet
   {
     irep_idt current_function;
-    bool hidden_function;
     loc_reft return_location;
     exprt return_lhs;
     exprt return_rhs;
     var_state_mapt saved_local_vars;
-
-    framet():hidden_function(false)
-    {
-    }
   };
 
   // call stack
@@ -89,7 +99,10 @@ public:
     var_valt local_vars; // thread-local variables
     bool active;
 
-    threadt():active(true)
+    // the sum of the hashes of the local_vars
+    std::size_t var_fingerprint;
+
+    threadt():active(true), var_fingerprint(0)
     {
     }
   };
@@ -125,8 +138,65 @@ public:
   // warning: reference is not stable
   var_statet &get_var_state(const var_mapt::var_infot &var_info);
 
+  // call after changing the state of a variable
+  void new_version(const var_mapt::var_infot &, var_statet &);
+
+  // forgets the values of the given variable of the current thread
+  void release(const irep_idt &symbol);
+
+  // the sum of the hashes of the shared_vars
+  std::size_t var_fingerprint;
+
+  // recomputes the sums of the hashes of the variables
+  void rehash();
+
+  // A hash of everything that determines the future of the state.
+  // The states of the variables and the constraints on the path
+  // only contribute their sums of hashes, which are maintained
+  // as they change, and thus the same state reached by reordering
+  // independent steps has the same fingerprint. The counters of
+  // loop iterations, depth and so on are not included, as they
+  // only serve to bound the search.
+  std::size_t fingerprint() const;
+
+  // whether the states agree in everything the fingerprint hashes,
+  // which rules out collisions of the fingerprints
+  bool same_as(const path_symex_statet &) const;
+
+  // whether the states are at the same locations
+  // and have the same call stacks
+  bool same_control(const path_symex_statet &) const;
+
   bool inside_atomic_section;
 
+  // the current thread has just been switched to,
+  // and runs at least one instruction before the next switch
+  bool scheduled;
+
+  // the shared objects an instruction may access, by symbol
+  struct footprintt
+  {
+    std::set<irep_idt> reads, writes;
+
+    // may access any object, e.g., through a pointer
+    bool any;
+
+    footprintt():any(false)
+    {
+    }
+
+    bool empty() const
+    {
+      return !any && reads.empty() && writes.empty();
+    }
+  };
+
+  // The sleep set: threads that need not run before one of the
+  // other threads does something their next instruction depends on,
+  // since that order has been explored on another path.
+  typedef std::map<unsigned, footprintt> sleep_sett;
+  sleep_sett sleep_set;
+
   unsigned get_current_thread() const
   {
     return current_thread;
@@ -139,7 +209,19 @@ public:
 
   goto_programt::const_targett get_instruction() const
   {
-    return pc().target;
+    return config.locs[pc()].target;
+  }
+
+  // precomputed information about the PC
+  const loct &get_loc() const
+  {
+    return config.locs[pc()];
+  }
+
+  // the target of the GOTO or START_THREAD at the PC
+  loc_reft get_branch_target() const
+  {
+    return config.locs[pc()].branch_target;
   }
 
   bool is_executable() const
@@ -180,30 +262,12 @@ public:
   irep_idt function_id() const
   {
     PRECONDITION(current_thread<threads.size());
-    return threads[current_thread].pc.function_identifier;
+    return config.locs[threads[current_thread].pc].function_identifier;
   }
 
   bool get_hide() const
   {
-    const auto &instruction = *get_instruction();
-
-    // we hide if the function is hidden or the instruction is hidden
-    if(instruction.source_location.get_hide())
-      return true;
-
-    if(!threads.empty() &&
-       !threads[current_thread].call_stack.empty() &&
-       threads[current_thread].call_stack.back().hidden_function)
-      return true;
-
-    // hide calls to __CPROVER_initialize
-    if(instruction.is_function_call() &&
-       instruction.get_function_call().function().id()==ID_symbol &&
-       to_symbol_expr(instruction.get_function_call().function()).get_identifier()==
-       CPROVER_PREFIX "initialize")
-      return true;
-
-    return false;
+    return get_loc().hidden;
   }
 
   void next_pc()
@@ -216,6 +280,10 @@ public:
     threads[current_thread].pc=new_pc;
   }
 
+  // approximate number of bytes held by the state,
+  // not counting the expressions, which are shared
+  std::size_t approx_memory() const;
+
   // output
   void output(std::ostream &out) const;
   void output(const threadt &thread, std::ostream &out) const;
@@ -234,6 +302,7 @@ public:
 
   exprt dereference_rec(const exprt &src, bool propagate);
   exprt dereference_rec_address(const exprt &src, bool propagate);
+  exprt resolve_pointer(const exprt &src);
 
   std::string array_index_as_string(const exprt &) const;
 
@@ -271,14 +340,53 @@ public:
 
   bool check_assertion(class decision_proceduret &);
 
-  // counts how many times we have executed backwards edges
-  typedef std::map<loc_reft, unsigned> unwinding_mapt;
-  unwinding_mapt unwinding_map;
+  // counts how many times we have executed backwards edges,
+  // indexed by loct::loop_index
+  typedef std::vector<unsigned> unwindingst;
+  unwindingst unwindings;
+
+  unsigned get_unwinding(std::size_t loop_index) const
+  {
+    return loop_index<unwindings.size()?unwindings[loop_index]:0;
+  }
+
+  void increase_unwinding(std::size_t loop_index)
+  {
+    if(unwindings.size()<=loop_index)
+      unwindings.resize(loop_index+1, 0);
+    unwindings[loop_index]++;
+  }
 
   // similar for recursive function calls
   typedef std::map<irep_idt, unsigned> recursion_mapt;
   recursion_mapt recursion_map;
 
+  // bounds on the SSA symbols, to decide branches without the solver
+  interval_domaint intervals;
+
+  // a call whose effect is recorded for function_summariest
+  struct summary_recordingt
+  {
+    irep_idt function;
+    exprt::operandst arguments;
+    unsigned thread;
+
+    // the size of the call stack in the callee
+    std::size_t frame;
+
+    // by var_infot::id, the values of the variables
+    // read before being written, and the variables written
+    std::map<unsigned, exprt> reads;
+    std::set<unsigned> writes;
+  };
+
+  // null unless recording, and reset when the call turns out
+  // to depend on values that are not concrete
+  std::shared_ptr<summary_recordingt> summary_recording;
+
+  void summary_read(const var_mapt::var_infot &, const exprt &value);
+  void summary_write(const var_mapt::var_infot &);
+
 protected:
   enum class statust { ACTIVE, INFEASIBLE, TERMINATED } status;
   unsigned current_thread;
@@ -290,10 +398,20 @@ protected:
     const exprt &src,
     bool propagate);
 
+  exprt read_uncached(
+    const exprt &src,
+    bool propagate);
+
+  bool is_current(const read_cachet::dependenciest &) const;
+
   exprt instantiate_rec(
     const exprt &src,
     bool propagate);
 
+  exprt instantiate_simplify_rec(
+    const exprt &src,
+    bool propagate);
+
   optionalt<exprt> instantiate_node(
     const exprt &src,
     bool propagate);
@@ -306,6 +424,8 @@ protected:
     bool propagate);
 
   bool is_symbol_member_index(const exprt &src) const;
+
+  friend class path_symext;
 };
 
 #endif // CPROVER_PATH_SYMEX_PATH_SYMEX_STATE_H
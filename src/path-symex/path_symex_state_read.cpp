@@ -11,7 +11,6 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "path_symex_state.h"
 
-#include <util/simplify_expr.h>
 #include <util/arith_tools.h>
 
 #ifdef DEBUG
@@ -19,10 +18,96 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <langapi/language_util.h>
 #endif
 
-#include "symex_dereference.h"
 #include "evaluate_address_of.h"
 
+/// Accumulates the time spent in the outermost read,
+/// if enabled by path_symex_configt::time_reads
+class read_timert
+{
+public:
+  explicit read_timert(path_symex_configt &_config):config(_config)
+  {
+    if(config.time_reads && config.read_depth++==0)
+      start=std::chrono::steady_clock::now();
+  }
+
+  ~read_timert()
+  {
+    if(config.time_reads && --config.read_depth==0)
+      config.read_time+=std::chrono::steady_clock::now()-start;
+  }
+
+protected:
+  path_symex_configt &config;
+  std::chrono::time_point<std::chrono::steady_clock> start;
+};
+
 exprt path_symex_statet::read(const exprt &src, bool propagate)
+{
+  read_timert read_timer(config);
+
+  read_cachet &read_cache=config.read_cache;
+
+  const read_cachet::entryt *entry=read_cache.find(src, propagate);
+
+  if(entry!=nullptr)
+  {
+    if(is_current(entry->dependencies))
+    {
+      read_cache.hits++;
+      read_cache.depends_on(entry->dependencies);
+
+      // the variables are not read again, but need to be recorded
+      if(propagate && summary_recording)
+      {
+        for(const auto &dependency : entry->dependencies)
+        {
+          const var_mapt::var_infot &var_info=
+            config.var_map[dependency.var_id];
+          summary_read(var_info, get_var_state(var_info).value);
+
+          if(!summary_recording)
+            break;
+        }
+      }
+
+      return entry->result;
+    }
+
+    read_cache.invalidated++;
+  }
+
+  read_cache.misses++;
+
+  read_cachet::recordert recorder(read_cache);
+  exprt result=read_uncached(src, propagate);
+  recorder.store(src, propagate, result);
+
+  return result;
+}
+
+/// \return whether the variables have the given versions in this state
+bool path_symex_statet::is_current(
+  const read_cachet::dependenciest &dependencies) const
+{
+  for(const auto &dependency : dependencies)
+  {
+    const var_mapt::var_infot &var_info=config.var_map[dependency.var_id];
+
+    const var_valt &var_val=
+      var_info.is_shared()?shared_vars:threads[current_thread].local_vars;
+
+    const std::size_t version=
+      var_info.number<var_val.size()?var_val[var_info.number].version:0;
+
+    if(version!=dependency.version)
+      return false;
+  }
+
+  return true;
+}
+
+exprt path_symex_statet::read_uncached(const exprt &src, bool propagate)
 {
   #ifdef DEBUG
   std::cout << "path_symex_statet::read " << from_expr(src) << '\n';
@@ -36,15 +121,20 @@ exprt path_symex_statet::read(const exprt &src, bool propagate)
   // we force propagation for dereferencing
   exprt tmp3=dereference_rec(src, true);
 
+  // phases 2 and 3 in one traversal?
+  if(config.fused_read)
+    return config.expr_store(instantiate_simplify_rec(tmp3, propagate));
+
   exprt tmp4=instantiate_rec(tmp3, propagate);
 
-  exprt tmp5=simplify_expr(tmp4, config.ns);
+  exprt tmp5=config.simplify(tmp4);
 
   #ifdef DEBUG
   std::cout << " ==> " << from_expr(tmp5) << '\n';
   #endif
 
-  return tmp5;
+  // share with equal results, e.g., of sibling paths
+  return config.expr_store(tmp5);
 }
 
 exprt path_symex_statet::expand_structs_and_arrays(const exprt &src)
@@ -90,7 +180,7 @@ exprt path_symex_statet::expand_structs_and_arrays(const exprt &src)
     const array_typet &array_type=to_array_type(src_type);
     const typet &subtype=array_type.subtype();
 
-    if(array_type.size().is_constant())
+    if(!config.var_map.is_unbounded_array(array_type))
     {
       auto size_int=numeric_cast<std::size_t>(to_constant_expr(array_type.size()));
 
@@ -103,12 +193,16 @@ exprt path_symex_statet::expand_structs_and_arrays(const exprt &src)
       // split it up into elements
       for(std::size_t i=0; i<size_int; ++i)
       {
-        exprt index=from_integer(i, array_type.size().type());
-        exprt new_src=index_exprt(src, index, subtype);
+        exprt new_src;
 
         // array constructor?
-        if(src.id()==ID_array)
-          new_src=simplify_expr(new_src, config.ns);
+        if(src.id()==ID_array && src.operands().size()==size_int.value())
+          new_src=src.operands()[i];
+        else
+        {
+          exprt index=from_integer(i, array_type.size().type());
+          new_src=index_exprt(src, index, subtype);
+        }
 
         // recursive call
         result.operands()[i]=expand_structs_and_arrays(new_src);
@@ -118,7 +212,8 @@ exprt path_symex_statet::expand_structs_and_arrays(const exprt &src)
     }
     else
     {
-      // TODO: variable-sized array
+      // TODO: variable-sized array;
+      // large arrays are kept as a whole
     }
   }
   else if(src_type.id()==ID_vector) // src is a vector
@@ -142,12 +237,16 @@ exprt path_symex_statet::expand_structs_and_arrays(const exprt &src)
     // split it up into elements
     for(std::size_t i=0; i<size_int; ++i)
     {
-      exprt index=from_integer(i, vector_type.size().type());
-      exprt new_src=index_exprt(src, index, subtype);
+      exprt new_src;
 
       // vector constructor?
-      if(src.id()==ID_vector)
-        new_src=simplify_expr(new_src, config.ns);
+      if(src.id()==ID_vector && src.operands().size()==size_int)
+        new_src=src.operands()[i];
+      else
+      {
+        exprt index=from_integer(i, vector_type.size().type());
+        new_src=index_exprt(src, index, subtype);
+      }
 
       // recursive call
       operands[i]=expand_structs_and_arrays(new_src);
@@ -159,6 +258,53 @@ exprt path_symex_statet::expand_structs_and_arrays(const exprt &src)
   return src;
 }
 
+/// \return a bound b such that \p index is less than b when it is
+///   non-negative, using cheap interval reasoning on its shape
+static optionalt<std::size_t> index_upper_bound(const exprt &index)
+{
+  if(index.id()==ID_typecast)
+  {
+    // e.g., an index of type 'unsigned char'
+    const typet &op_type=to_typecast_expr(index).op().type();
+
+    if(op_type.id()==ID_bool)
+      return 2;
+    else if(op_type.id()==ID_unsignedbv ||
+            op_type.id()==ID_signedbv ||
+            op_type.id()==ID_c_bool)
+    {
+      std::size_t width=to_bitvector_type(op_type).get_width();
+
+      if(op_type.id()==ID_signedbv)
+        width--;
+
+      if(width<sizeof(std::size_t)*8)
+        return std::size_t(1)<<width;
+    }
+  }
+  else if(index.id()==ID_mod)
+  {
+    // i%c
+    const auto c=numeric_cast<mp_integer>(to_mod_expr(index).divisor());
+
+    if(c.has_value() && *c>0)
+      return numeric_cast<std::size_t>(*c);
+  }
+  else if(index.id()==ID_bitand)
+  {
+    // i&c
+    for(const auto &op : index.operands())
+    {
+      const auto c=numeric_cast<mp_integer>(op);
+
+      if(c.has_value() && *c>=0)
+        return numeric_cast<std::size_t>(*c+1);
+    }
+  }
+
+  return {};
+}
+
 exprt path_symex_statet::array_theory(const exprt &src, bool propagate)
 {
   if(src.id()==ID_index)
@@ -166,23 +312,29 @@ exprt path_symex_statet::array_theory(const exprt &src, bool propagate)
     const index_exprt &index_expr=to_index_expr(src);
     const array_typet &array_type=to_array_type(index_expr.array().type());
 
-    if(var_mapt::is_unbounded_array(array_type))
+    if(config.var_map.is_unbounded_array(array_type))
     {
     }
     else
     {
       exprt index_tmp1=read(index_expr.index(), propagate);
-      exprt index_tmp2=simplify_expr(index_tmp1, config.ns);
+      exprt index_tmp2=config.simplify(index_tmp1);
 
       if(!index_tmp2.is_constant())
       {
         const typet &subtype=array_type.subtype();
 
-        const auto size_int=numeric_cast<std::size_t>(array_type.size());
+        auto size_int=numeric_cast<std::size_t>(array_type.size());
 
         if(!size_int.has_value())
           throw "failed to convert array size";
 
+        // Indices beyond the bound cannot be taken;
+        // this is common for table lookups.
+        const auto bound=index_upper_bound(index_tmp2);
+        if(bound.has_value() && *bound<*size_int)
+          size_int=*bound;
+
         // Split it up using a cond_exprt.
         // A cond_exprt is depth 1 compared to depth n when
         // using a nesting of if_exprt
@@ -206,6 +358,75 @@ exprt path_symex_statet::array_theory(const exprt &src, bool propagate)
   return src;
 }
 
+/// Selects components of aggregates lazily, by pushing member and
+/// index expressions into if-expressions and constructors, e.g., the
+/// dereferencing result (p==&s1?s1:s2).x becomes p==&s1?s1.x:s2.x.
+/// This saves us from instantiating the aggregates as a whole.
+static optionalt<exprt> select_component(
+  const exprt &src,
+  const namespacet &ns)
+{
+  if(src.id()!=ID_member && src.id()!=ID_index)
+    return {};
+
+  // the aggregate is operand 0 of both member and index
+  const auto selected_op=select_component(src.op0(), ns);
+  const exprt &op=selected_op.has_value()?*selected_op:src.op0();
+
+  if(op.id()==ID_if)
+  {
+    const if_exprt &if_expr=to_if_expr(op);
+
+    exprt true_case=src;
+    true_case.op0()=if_expr.true_case();
+    const auto selected_true=select_component(true_case, ns);
+
+    exprt false_case=src;
+    false_case.op0()=if_expr.false_case();
+    const auto selected_false=select_component(false_case, ns);
+
+    return if_exprt(
+      if_expr.cond(),
+      selected_true.has_value()?*selected_true:true_case,
+      selected_false.has_value()?*selected_false:false_case,
+      src.type());
+  }
+  else if(src.id()==ID_member && op.id()==ID_struct)
+  {
+    const typet &op_type=ns.follow(op.type());
+
+    if(op_type.id()==ID_struct)
+    {
+      const irep_idt &component_name=
+        to_member_expr(src).get_component_name();
+      const struct_typet &struct_type=to_struct_type(op_type);
+
+      if(struct_type.has_component(component_name))
+      {
+        const std::size_t n=struct_type.component_number(component_name);
+        if(n<op.operands().size())
+          return op.operands()[n];
+      }
+    }
+  }
+  else if(src.id()==ID_index && op.id()==ID_array)
+  {
+    const auto index=numeric_cast<std::size_t>(to_index_expr(src).index());
+
+    if(index.has_value() && *index<op.operands().size())
+      return op.operands()[*index];
+  }
+
+  if(selected_op.has_value())
+  {
+    exprt result=src;
+    result.op0()=*selected_op;
+    return std::move(result);
+  }
+
+  return {};
+}
+
 optionalt<exprt> path_symex_statet::instantiate_node(
   const exprt &src,
   bool propagate)
@@ -215,6 +436,11 @@ optionalt<exprt> path_symex_statet::instantiate_node(
             << from_expr(config.ns, "", src) << '\n';
   #endif
 
+  // only instantiate the components we access
+  const auto selected=select_component(src, config.ns);
+  if(selected.has_value())
+    return instantiate_rec(selected.value(), propagate);
+
   // check whether this is a symbol(.member|[index])*
 
   if(is_symbol_member_index(src))
@@ -246,6 +472,7 @@ optionalt<exprt> path_symex_statet::instantiate_node(
       nondet_symbol.base_name=id;
       nondet_symbol.type=src.type();
       config.var_map.new_symbols.add(nondet_symbol);
+      config.read_cache.not_cacheable();
 
       return read_symbol_member_index(nondet_symbol.symbol_expr(), false);
     }
@@ -270,6 +497,7 @@ optionalt<exprt> path_symex_statet::instantiate_node(
     nondet_symbol.base_name=id;
     nondet_symbol.type=src.type();
     config.var_map.new_symbols.add(nondet_symbol);
+    config.read_cache.not_cacheable();
 
     return nondet_symbol.symbol_expr();
   }
@@ -313,6 +541,7 @@ optionalt<exprt> path_symex_statet::instantiate_node(
     nondet_symbol.base_name=id;
     nondet_symbol.type=src.type();
     config.var_map.new_symbols.add(nondet_symbol);
+    config.read_cache.not_cacheable();
 
     return nondet_symbol.symbol_expr();
   }
@@ -348,6 +577,95 @@ exprt path_symex_statet::instantiate_rec(
   return tmp_src;
 }
 
+/// Rewrites to SSA symbols and simplifies in a single post-order
+/// traversal. Subtrees that do not change are shared with 'src',
+/// and the simplifier only needs to look at each node once,
+/// as its operands have been simplified already.
+exprt path_symex_statet::instantiate_simplify_rec(
+  const exprt &src,
+  bool propagate)
+{
+  struct framet
+  {
+    const exprt &src;
+    std::size_t next_op;
+    bool changed;
+    exprt result;
+
+    explicit framet(const exprt &_src):
+      src(_src), next_op(0), changed(false)
+    {
+    }
+  };
+
+  {
+    auto root_result=instantiate_node(src, propagate);
+    if(root_result.has_value())
+      return config.simplify(root_result.value());
+  }
+
+  std::vector<framet> stack;
+  stack.emplace_back(src);
+
+  while(true)
+  {
+    framet &frame=stack.back();
+    const exprt &node=frame.src;
+
+    if(frame.next_op<node.operands().size())
+    {
+      const exprt &op=node.operands()[frame.next_op];
+      auto op_result=instantiate_node(op, propagate);
+
+      if(!op_result.has_value())
+      {
+        // descend into the operand
+        stack.emplace_back(op);
+        continue;
+      }
+
+      if(!frame.changed)
+      {
+        frame.result=node;
+        frame.changed=true;
+      }
+
+      frame.result.operands()[frame.next_op]=
+        config.simplify(op_result.value());
+      frame.next_op++;
+      continue;
+    }
+
+    // all operands done, now simplify the node itself
+    exprt node_result=frame.changed?std::move(frame.result):node;
+    bool changed=frame.changed;
+
+    if(node_result.has_operands() &&
+       !config.simplify.simplify_node(node_result))
+      changed=true;
+
+    stack.pop_back();
+
+    if(stack.empty())
+      return node_result;
+
+    framet &parent=stack.back();
+
+    if(changed)
+    {
+      if(!parent.changed)
+      {
+        parent.result=parent.src;
+        parent.changed=true;
+      }
+
+      parent.result.operands()[parent.next_op]=std::move(node_result);
+    }
+
+    parent.next_op++;
+  }
+}
+
 exprt path_symex_statet::read_symbol_member_index(
   const exprt &src,
   bool propagate)
@@ -361,7 +679,7 @@ exprt path_symex_statet::read_symbol_member_index(
 
   // unbounded array?
   if(src.id()==ID_index &&
-     var_mapt::is_unbounded_array(to_index_expr(src).array().type()))
+     config.var_map.is_unbounded_array(to_index_expr(src).array().type()))
   {
     index_exprt new_src=to_index_expr(src);
     new_src.array()=read_symbol_member_index(new_src.array(), propagate); // rec. call
@@ -453,8 +771,12 @@ exprt path_symex_statet::read_symbol_member_index(
   // warning: reference is not stable
   var_statet &var_state=get_var_state(var_info);
 
+  if(propagate && summary_recording)
+    summary_read(var_info, var_state.value);
+
   if(propagate && var_state.value.is_not_nil())
   {
+    config.read_cache.depends_on(var_info.id, var_state.version);
     return var_state.value; // propagate a value
   }
   else
@@ -464,9 +786,10 @@ exprt path_symex_statet::read_symbol_member_index(
     {
       // produce one
       var_state.ssa_symbol=var_info.ssa_symbol();
+      new_version(var_info, var_state);
 
       // ssa-ify the size
-      if(var_mapt::is_unbounded_array(var_state.ssa_symbol.type()))
+      if(config.var_map.is_unbounded_array(var_state.ssa_symbol.type()))
       {
         // disabled to preserve type consistency
         // exprt &size=to_array_type(var_state.ssa_symbol.type()).size();
@@ -474,6 +797,7 @@ exprt path_symex_statet::read_symbol_member_index(
       }
     }
 
+    config.read_cache.depends_on(var_info.id, var_state.version);
     return var_state.ssa_symbol;
   }
 }
@@ -534,7 +858,7 @@ bool path_symex_statet::is_symbol_member_index(const exprt &src) const
 
 std::string path_symex_statet::array_index_as_string(const exprt &src) const
 {
-  exprt tmp=simplify_expr(src, config.ns);
+  exprt tmp=config.simplify(src);
 
   auto index_int = numeric_cast<mp_integer>(tmp);
 
@@ -548,41 +872,174 @@ exprt path_symex_statet::dereference_rec(
   const exprt &src,
   bool propagate)
 {
-  if(src.id()==ID_dereference)
+  // the most common case: a symbol or a constant
+  if(src.operands().empty())
+    return src;
+
+  // A post-order traversal with an explicit stack. Subtrees without
+  // dereferences are shared with 'src', not rebuilt, and a node is
+  // copied only once one of its operands has changed. Leaves get no
+  // frame, as dereferences and addresses have operands.
+  std::vector<path_symex_configt::dereference_framet> &stack=
+    config.dereference_stack;
+  const std::size_t base=stack.size();
+  stack.emplace_back(src);
+
+  while(true)
   {
-    const dereference_exprt &dereference_expr=to_dereference_expr(src);
+    const exprt &node=*stack.back().src;
+    exprt node_result;
+    bool changed=true;
+
+    if(node.id()==ID_dereference)
+    {
+      const dereference_exprt &dereference_expr=to_dereference_expr(node);
 
-    // read the address to propagate the pointers
-    exprt address=read(dereference_expr.pointer(), propagate);
+      // read the address to propagate the pointers
+      exprt address=read(dereference_expr.pointer(), propagate);
 
-    // now hand over to dereference
-    exprt address_dereferenced=::symex_dereference(address, config.ns);
+      if(config.points_to.is_enabled())
+        address=resolve_pointer(address);
 
-    // the dereferenced address is a mixture of non-SSA and SSA symbols
-    // (e.g., if-guards and array indices)
-    return address_dereferenced;
+      // now hand over to dereference;
+      // the dereferenced address is a mixture of non-SSA and SSA symbols
+      // (e.g., if-guards and array indices)
+      node_result=config.dereference(address);
+    }
+    else if(node.id()==ID_address_of)
+    {
+      node_result=evaluate_address_of(to_address_of_expr(node), config.ns);
+    }
+    else if(stack.back().next_op<node.operands().size())
+    {
+      const exprt &op=node.operands()[stack.back().next_op];
+
+      // descend into the next operand, unless it is a leaf
+      if(op.operands().empty())
+        stack.back().next_op++;
+      else
+        stack.emplace_back(op);
+
+      continue;
+    }
+    else
+    {
+      // all operands done
+      changed=stack.back().changed;
+      node_result=changed?std::move(stack.back().result):node;
+    }
+
+    stack.pop_back();
+
+    if(stack.size()==base)
+      return node_result;
+
+    path_symex_configt::dereference_framet &parent=stack.back();
+
+    if(changed)
+    {
+      if(!parent.changed)
+      {
+        parent.result=*parent.src;
+        parent.changed=true;
+      }
+
+      parent.result.operands()[parent.next_op]=std::move(node_result);
+    }
+
+    parent.next_op++;
   }
-  else if(src.id()==ID_address_of)
+}
+
+/// Uses the points-to analysis to turn a pointer that has not been
+/// propagated to an address into a case split over the objects it may
+/// point to. We only do so when all these objects have the type the
+/// pointer points to, as then the offset has to be zero. A pointer that
+/// may also be NULL or invalid keeps itself as the last case.
+exprt path_symex_statet::resolve_pointer(const exprt &src)
+{
+  if(src.id()==ID_address_of || src.id()==ID_constant)
+    return src;
+  else if(src.id()==ID_if)
   {
-    const auto &address_of_expr=to_address_of_expr(src);
-    const exprt tmp=evaluate_address_of(address_of_expr, config.ns);
-    return tmp;
+    if_exprt if_expr=to_if_expr(src);
+    if_expr.true_case()=resolve_pointer(if_expr.true_case());
+    if_expr.false_case()=resolve_pointer(if_expr.false_case());
+    return std::move(if_expr);
   }
+  else if(src.id()==ID_typecast &&
+          to_typecast_expr(src).op().type().id()==ID_pointer)
+  {
+    typecast_exprt typecast_expr=to_typecast_expr(src);
+    typecast_expr.op()=resolve_pointer(typecast_expr.op());
+    return std::move(typecast_expr);
+  }
+
+  const typet &pointer_type=config.ns.follow(src.type());
+
+  if(pointer_type.id()!=ID_pointer)
+    return src;
+
+  // find the SSA symbol the pointer is stored in
+  const exprt *root=&src;
+
+  while(root->id()==ID_member ||
+        root->id()==ID_index ||
+        root->id()==ID_byte_extract_little_endian ||
+        root->id()==ID_byte_extract_big_endian)
+    root=&root->op0();
+
+  if(root->id()!=ID_symbol)
+    return src;
+
+  const var_mapt::var_infot *var_info=
+    config.var_map.find(root->get(ID_C_full_identifier));
+
+  if(var_info==nullptr)
+    return src;
+
+  const points_tot::object_sett *objects=config.points_to(var_info->symbol);
 
-  if(!src.has_operands())
+  if(objects==nullptr || objects->empty())
     return src;
 
-  exprt src2=src;
+  const typet &subtype=config.ns.follow(pointer_type.subtype());
 
+  exprt::operandst addresses;
+  bool may_be_null=false;
+
+  for(const auto &object : *objects)
   {
-    // recursive calls on structure of 'src'
-    for(auto &op : src2.operands())
+    if(object==ID_NULL)
     {
-      exprt tmp_op=dereference_rec(op, propagate);
-      op=tmp_op;
+      may_be_null=true;
+      continue;
     }
+
+    const symbolt *symbol;
+
+    if(config.ns.lookup(object, symbol) ||
+       config.ns.follow(symbol->type)!=subtype)
+      return src;
+
+    addresses.push_back(
+      typecast_exprt::conditional_cast(
+        address_of_exprt(symbol->symbol_expr()), src.type()));
   }
 
-  return src2;
-}
+  if(addresses.empty())
+    return src;
 
+  config.points_to.resolved++;
+
+  if(addresses.size()==1 && !may_be_null)
+    return addresses.front();
+
+  // anything else, including NULL, is left to symex_dereferencet
+  exprt result=src;
+
+  for(const auto &address : addresses)
+    result=if_exprt(equal_exprt(src, address), address, result);
+
+  return result;
+}
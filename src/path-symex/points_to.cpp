@@ -0,0 +1,342 @@
+/*******************************************************************\
+
+Module: Flow-insensitive Points-to Analysis
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Flow-insensitive Points-to Analysis
+
+#include "points_to.h"
+
+#include <util/std_code.h>
+#include <util/std_expr.h>
+
+irep_idt points_tot::return_value(const irep_idt &function)
+{
+  return id2string(function)+"#return_value";
+}
+
+void points_tot::operator()(const goto_functionst &goto_functions)
+{
+  map.clear();
+  unsound=false;
+
+  collect(goto_functions);
+
+  // iterate until we reach the fixed point
+  bool changed;
+
+  do
+  {
+    changed=false;
+
+    for(const auto &assignment : assignments)
+    {
+      object_sett rhs_values;
+      values(assignment.rhs, rhs_values);
+      if(assign(assignment.lhs, rhs_values))
+        changed=true;
+    }
+
+    for(const auto &c : calls)
+      if(call(c, goto_functions))
+        changed=true;
+  }
+  while(changed);
+
+  assignments.clear();
+  calls.clear();
+
+  // a store via a pointer we cannot name may go anywhere
+  enabled=!unsound;
+}
+
+const points_tot::object_sett *points_tot::operator()(
+  const irep_idt &identifier) const
+{
+  mapt::const_iterator it=map.find(identifier);
+
+  if(it==map.end() || it->second.count(ID_unknown)!=0)
+    return nullptr;
+
+  return &it->second;
+}
+
+void points_tot::collect(const goto_functionst &goto_functions)
+{
+  forall_goto_functions(f_it, goto_functions)
+  {
+    const symbol_exprt return_symbol(
+      return_value(f_it->first), f_it->second.type.return_type());
+
+    forall_goto_program_instructions(i_it, f_it->second.body)
+    {
+      const goto_programt::instructiont &instruction=*i_it;
+
+      if(instruction.is_assign())
+      {
+        const code_assignt &code_assign=instruction.get_assign();
+        assignments.push_back({code_assign.lhs(), code_assign.rhs()});
+      }
+      else if(instruction.is_decl())
+      {
+        // uninitialised pointers are invalid
+        const symbol_exprt &symbol=instruction.get_decl().symbol();
+        if(may_hold_pointer(symbol.type(), ns))
+          map[symbol.get_identifier()].insert(ID_NULL);
+      }
+      else if(instruction.is_return())
+      {
+        if(instruction.code.operands().size()==1)
+          assignments.push_back({return_symbol, instruction.code.op0()});
+      }
+      else if(instruction.is_function_call())
+      {
+        const code_function_callt &code_function_call=
+          instruction.get_function_call();
+
+        calls.push_back(
+          { code_function_call.lhs(),
+            code_function_call.function(),
+            code_function_call.arguments() });
+      }
+    }
+  }
+}
+
+/// adds \p values to the points-to sets of the objects \p lhs may denote
+/// \return true if a points-to set has changed
+bool points_tot::assign(const exprt &lhs, const object_sett &values)
+{
+  if(values.empty())
+    return false;
+
+  object_sett lhs_targets;
+  targets(lhs, lhs_targets);
+
+  bool changed=false;
+
+  for(const auto &target : lhs_targets)
+  {
+    if(target==ID_unknown)
+    {
+      unsound=true;
+      continue;
+    }
+    else if(target==ID_NULL)
+      continue; // not an object
+
+    object_sett &dest=map[target];
+    const std::size_t old_size=dest.size();
+    dest.insert(values.begin(), values.end());
+
+    if(dest.size()!=old_size)
+      changed=true;
+  }
+
+  return changed;
+}
+
+/// binds the parameters and the return value of all possible callees
+/// \return true if a points-to set has changed
+bool points_tot::call(const callt &c, const goto_functionst &goto_functions)
+{
+  object_sett callees;
+
+  if(c.function.id()==ID_symbol)
+    callees.insert(to_symbol_expr(c.function).get_identifier());
+  else
+    objects(c.function, callees);
+
+  bool changed=false;
+
+  for(const auto &callee : callees)
+  {
+    // symex cannot call these either
+    if(callee==ID_unknown)
+      continue;
+
+    const auto f_it=goto_functions.function_map.find(callee);
+
+    if(f_it==goto_functions.function_map.end())
+      continue;
+
+    const code_typet::parameterst &parameters=
+      f_it->second.type.parameters();
+
+    for(std::size_t i=0; i<parameters.size() && i<c.arguments.size(); i++)
+    {
+      const irep_idt &identifier=parameters[i].get_identifier();
+
+      if(identifier.empty())
+        continue;
+
+      object_sett argument_values;
+      values(c.arguments[i], argument_values);
+
+      if(assign(symbol_exprt(identifier, parameters[i].type()),
+                argument_values))
+        changed=true;
+    }
+
+    if(c.lhs.is_not_nil())
+    {
+      object_sett return_values;
+
+      if(f_it->second.body_available())
+      {
+        mapt::const_iterator m_it=map.find(return_value(callee));
+        if(m_it!=map.end())
+          return_values=m_it->second;
+      }
+      else if(may_hold_pointer(c.lhs.type(), ns))
+        return_values.insert(ID_unknown);
+
+      if(assign(c.lhs, return_values))
+        changed=true;
+    }
+  }
+
+  return changed;
+}
+
+/// collects the objects the pointers in the value of \p src may point to
+void points_tot::values(const exprt &src, object_sett &dest) const
+{
+  if(src.id()==ID_address_of)
+  {
+    objects(to_address_of_expr(src).object(), dest);
+  }
+  else if(src.id()==ID_symbol)
+  {
+    mapt::const_iterator m_it=
+      map.find(to_symbol_expr(src).get_identifier());
+
+    if(m_it!=map.end())
+      dest.insert(m_it->second.begin(), m_it->second.end());
+  }
+  else if(src.id()==ID_member ||
+          src.id()==ID_index ||
+          src.id()==ID_byte_extract_little_endian ||
+          src.id()==ID_byte_extract_big_endian)
+  {
+    // field-insensitive
+    values(src.op0(), dest);
+  }
+  else if(src.id()==ID_dereference)
+  {
+    object_sett pointees;
+    values(to_dereference_expr(src).pointer(), pointees);
+
+    for(const auto &pointee : pointees)
+    {
+      if(pointee==ID_unknown)
+        dest.insert(ID_unknown);
+      else
+        values(symbol_exprt(pointee, src.type()), dest);
+    }
+  }
+  else if(src.id()==ID_typecast)
+  {
+    const exprt &op=to_typecast_expr(src).op();
+    const typet &op_type=ns.follow(op.type());
+
+    values(op, dest);
+
+    // integers turned into pointers
+    if(src.type().id()==ID_pointer && op_type.id()!=ID_pointer)
+      dest.insert(op.is_zero()?ID_NULL:ID_unknown);
+  }
+  else if(src.id()==ID_constant)
+  {
+    if(src.type().id()==ID_pointer)
+    {
+      if(to_constant_expr(src).get_value()==ID_NULL || src.is_zero())
+        dest.insert(ID_NULL);
+      else
+        dest.insert(ID_unknown);
+    }
+  }
+  else if((src.id()==ID_plus || src.id()==ID_minus) &&
+          src.type().id()==ID_pointer)
+  {
+    // the offset may be anything
+    dest.insert(ID_unknown);
+  }
+  else if(src.id()==ID_side_effect)
+  {
+    // allocation, nondet, and the like
+    if(may_hold_pointer(src.type(), ns))
+      dest.insert(ID_unknown);
+  }
+  else
+  {
+    forall_operands(it, src)
+      values(*it, dest);
+  }
+}
+
+/// collects the objects \p src may denote, when taking its address
+void points_tot::objects(const exprt &src, object_sett &dest) const
+{
+  if(src.id()==ID_symbol)
+    dest.insert(to_symbol_expr(src).get_identifier());
+  else if(src.id()==ID_member ||
+          src.id()==ID_index ||
+          src.id()==ID_byte_extract_little_endian ||
+          src.id()==ID_byte_extract_big_endian ||
+          src.id()==ID_typecast)
+    objects(src.op0(), dest);
+  else if(src.id()==ID_dereference)
+    values(to_dereference_expr(src).pointer(), dest);
+  else if(src.id()==ID_if)
+  {
+    objects(to_if_expr(src).true_case(), dest);
+    objects(to_if_expr(src).false_case(), dest);
+  }
+  else
+    dest.insert(ID_unknown); // e.g., string literals
+}
+
+/// collects the objects an assignment to \p lhs may write to
+void points_tot::targets(const exprt &lhs, object_sett &dest) const
+{
+  if(lhs.id()==ID_symbol)
+    dest.insert(to_symbol_expr(lhs).get_identifier());
+  else if(lhs.id()==ID_member ||
+          lhs.id()==ID_index ||
+          lhs.id()==ID_byte_extract_little_endian ||
+          lhs.id()==ID_byte_extract_big_endian ||
+          lhs.id()==ID_typecast)
+    targets(lhs.op0(), dest);
+  else if(lhs.id()==ID_dereference)
+    values(to_dereference_expr(lhs).pointer(), dest);
+  else if(lhs.id()==ID_if)
+  {
+    targets(to_if_expr(lhs).true_case(), dest);
+    targets(to_if_expr(lhs).false_case(), dest);
+  }
+}
+
+bool may_hold_pointer(const typet &type, const namespacet &ns)
+{
+  const typet &t=ns.follow(type);
+
+  if(t.id()==ID_pointer)
+    return true;
+  else if(t.id()==ID_struct || t.id()==ID_union)
+  {
+    for(const auto &component : to_struct_union_type(t).components())
+      if(may_hold_pointer(component.type(), ns))
+        return true;
+
+    return false;
+  }
+  else if(t.id()==ID_array || t.id()==ID_vector)
+    return may_hold_pointer(t.subtype(), ns);
+  else
+    return false;
+}
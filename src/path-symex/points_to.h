@@ -0,0 +1,89 @@
+/*******************************************************************\
+
+Module: Flow-insensitive Points-to Analysis
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Flow-insensitive Points-to Analysis
+
+#ifndef CPROVER_PATH_SYMEX_POINTS_TO_H
+#define CPROVER_PATH_SYMEX_POINTS_TO_H
+
+#include <map>
+#include <set>
+
+#include <goto-programs/goto_functions.h>
+
+/// An inclusion-based (Andersen-style) points-to analysis that is
+/// flow-, context- and field-insensitive: for every variable, we
+/// compute a superset of the objects that any pointer stored anywhere
+/// in the variable may point to. Objects are identified by the
+/// identifier of their symbol. Pointers that may point to something
+/// we cannot name, e.g., dynamically allocated memory, have ID_unknown
+/// in their set, and pointers that may be NULL or invalid, e.g., when
+/// uninitialised, have ID_NULL in their set.
+class points_tot
+{
+public:
+  explicit points_tot(const namespacet &_ns):
+    resolved(0), ns(_ns), enabled(false), unsound(false)
+  {
+  }
+
+  void operator()(const goto_functionst &);
+
+  bool is_enabled() const
+  {
+    return enabled;
+  }
+
+  typedef std::set<irep_idt> object_sett;
+
+  /// \return the objects that the pointers stored in the variable
+  ///   with given identifier may point to, or nullptr if unknown
+  const object_sett *operator()(const irep_idt &identifier) const;
+
+  // statistics
+  std::size_t resolved;
+
+protected:
+  const namespacet &ns;
+  bool enabled;
+
+  typedef std::map<irep_idt, object_sett> mapt;
+  mapt map;
+
+  struct assignmentt
+  {
+    exprt lhs, rhs;
+  };
+
+  struct callt
+  {
+    exprt lhs, function;
+    exprt::operandst arguments;
+  };
+
+  std::vector<assignmentt> assignments;
+  std::vector<callt> calls;
+
+  // set when we store via a pointer to something we cannot name
+  bool unsound;
+
+  void collect(const goto_functionst &);
+  bool assign(const exprt &lhs, const object_sett &values);
+  bool call(const callt &, const goto_functionst &);
+  void values(const exprt &, object_sett &dest) const;
+  void objects(const exprt &, object_sett &dest) const;
+  void targets(const exprt &, object_sett &dest) const;
+
+  static irep_idt return_value(const irep_idt &function);
+};
+
+/// \return whether objects of the given type contain pointers
+bool may_hold_pointer(const typet &, const namespacet &);
+
+#endif // CPROVER_PATH_SYMEX_POINTS_TO_H
@@ -0,0 +1,52 @@
+/*******************************************************************\
+
+Module: Memo Cache for the Read Pipeline
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Memo Cache for the Read Pipeline
+
+#include "read_cache.h"
+
+#include <util/invariant.h>
+
+read_cachet::recordert::~recordert()
+{
+  PRECONDITION(!cache.frames.empty());
+
+  framet frame;
+  frame.cacheable=cache.frames.back().cacheable;
+  frame.dependencies.swap(cache.frames.back().dependencies);
+  cache.frames.pop_back();
+
+  // pass on to the enclosing read
+  if(!cache.frames.empty())
+  {
+    if(!frame.cacheable)
+      cache.not_cacheable();
+
+    cache.depends_on(frame.dependencies);
+  }
+}
+
+void read_cachet::recordert::store(
+  const exprt &src,
+  bool propagate,
+  const exprt &result)
+{
+  const framet &frame=cache.frames.back();
+
+  if(!frame.cacheable ||
+     frame.dependencies.size()>max_dependencies)
+    return;
+
+  if(cache.size()>=max_size)
+    cache.clear();
+
+  entryt &entry=cache.maps[propagate][src];
+  entry.result=result;
+  entry.dependencies=frame.dependencies;
+}
@@ -0,0 +1,145 @@
+/*******************************************************************\
+
+Module: Memo Cache for the Read Pipeline
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Memo Cache for the Read Pipeline
+
+#ifndef CPROVER_PATH_SYMEX_READ_CACHE_H
+#define CPROVER_PATH_SYMEX_READ_CACHE_H
+
+#include <unordered_map>
+#include <vector>
+
+#include <util/expr.h>
+
+/// Remembers the results of path_symex_statet::read together with
+/// the versions of the variables that the result depends on.
+/// Every change of the state of a variable stamps it with a fresh,
+/// globally unique version; hence, a result can be reused by any
+/// state in which the variables it depends on carry the same versions.
+class read_cachet
+{
+public:
+  read_cachet():
+    hits(0), misses(0), invalidated(0), version_counter(0)
+  {
+  }
+
+  struct dependencyt
+  {
+    unsigned var_id;
+    std::size_t version;
+  };
+
+  typedef std::vector<dependencyt> dependenciest;
+
+  struct entryt
+  {
+    exprt result;
+    dependenciest dependencies;
+  };
+
+  /// \return the entry for \p src, or nullptr;
+  ///   the caller has to check the dependencies
+  const entryt *find(const exprt &src, bool propagate) const
+  {
+    const mapt &map=maps[propagate];
+    mapt::const_iterator it=map.find(src);
+    return it==map.end()?nullptr:&it->second;
+  }
+
+  /// a fresh version for the state of a variable
+  std::size_t new_version()
+  {
+    return ++version_counter;
+  }
+
+  /// Records the dependencies of a read that is in progress,
+  /// which are passed on to the enclosing read, if any.
+  class recordert
+  {
+  public:
+    explicit recordert(read_cachet &_cache):cache(_cache)
+    {
+      cache.frames.push_back(framet());
+    }
+
+    ~recordert();
+
+    /// stores \p result if it does not depend on fresh symbols
+    void store(const exprt &src, bool propagate, const exprt &result);
+
+  protected:
+    read_cachet &cache;
+  };
+
+  /// the read in progress depends on the given version of a variable
+  void depends_on(unsigned var_id, std::size_t version)
+  {
+    if(!frames.empty())
+      frames.back().dependencies.push_back(dependencyt{var_id, version});
+  }
+
+  void depends_on(const dependenciest &dependencies)
+  {
+    if(!frames.empty())
+      frames.back().dependencies.insert(
+        frames.back().dependencies.end(),
+        dependencies.begin(),
+        dependencies.end());
+  }
+
+  /// the read in progress produces fresh symbols, e.g., for nondet
+  void not_cacheable()
+  {
+    if(!frames.empty())
+      frames.back().cacheable=false;
+  }
+
+  std::size_t size() const
+  {
+    return maps[0].size()+maps[1].size();
+  }
+
+  void clear()
+  {
+    maps[0].clear();
+    maps[1].clear();
+  }
+
+  // statistics
+  std::size_t hits, misses, invalidated;
+
+  // we clear the cache when it gets bigger than this
+  static const std::size_t max_size=1<<16;
+
+  // reads that depend on more variables are not cached,
+  // as checking them would not be cheaper than reading
+  static const std::size_t max_dependencies=32;
+
+protected:
+  std::size_t version_counter;
+
+  typedef std::unordered_map<exprt, entryt, irep_hash, irep_full_eq> mapt;
+
+  // indexed by 'propagate'
+  mapt maps[2];
+
+  struct framet
+  {
+    bool cacheable;
+    dependenciest dependencies;
+    framet():cacheable(true)
+    {
+    }
+  };
+
+  std::vector<framet> frames;
+};
+
+#endif // CPROVER_PATH_SYMEX_READ_CACHE_H
@@ -0,0 +1,38 @@
+/*******************************************************************\
+
+Module: Cache for the Simplifier
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Cache for the Simplifier
+
+#include "simplify_cache.h"
+
+#include <util/simplify_expr.h>
+
+exprt simplify_cachet::operator()(const exprt &src)
+{
+  // nothing to be done for these
+  if(src.id()==ID_constant || src.id()==ID_symbol)
+    return src;
+
+  const exprt &key=expr_store(src);
+
+  mapt::const_iterator it=map.find(key);
+
+  if(it!=map.end())
+  {
+    hits++;
+    return it->second;
+  }
+
+  misses++;
+
+  const exprt &result=expr_store(simplify_expr(key, ns));
+  map.emplace(key, result);
+
+  return result;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************\
+
+Module: Cache for the Simplifier
+
+Author: Daniel Kroening, kroening@kroening.com
+
+\*******************************************************************/
+
+/// \file
+/// Cache for the Simplifier
+
+#ifndef CPROVER_PATH_SYMEX_SIMPLIFY_CACHE_H
+#define CPROVER_PATH_SYMEX_SIMPLIFY_CACHE_H
+
+#include <unordered_map>
+
+#include <util/simplify_expr_class.h>
+
+#include "expr_store.h"
+
+/// Remembers the results of simplify_expr across all states.
+/// The keys are hash-consed by the expression store,
+/// and thus hashing and comparing them is O(1). As keys and
+/// results are entries of the store, the cache is only cleared
+/// together with it, see path_symex_configt::bound_caches.
+class simplify_cachet
+{
+public:
+  simplify_cachet(const namespacet &_ns, expr_storet &_expr_store):
+    hits(0), misses(0), ns(_ns), expr_store(_expr_store), simplifier(_ns)
+  {
+  }
+
+  /// \return simplify_expr(src), as store-canonical expression
+  exprt operator()(const exprt &src);
+
+  /// simplifies the top-level node of \p expr only,
+  /// assuming that its operands are simplified already;
+  /// this is not cached
+  /// \return true if \p expr is unchanged
+  bool simplify_node(exprt &expr)
+  {
+    return simplifier.simplify_node(expr);
+  }
+
+  std::size_t size() const
+  {
+    return map.size();
+  }
+
+  void clear()
+  {
+    map.clear();
+  }
+
+  // statistics
+  std::size_t hits, misses;
+
+  // the store and the cache are cleared when it gets bigger than this
+  static const std::size_t max_size=1<<16;
+
+protected:
+  const namespacet &ns;
+  expr_storet &expr_store;
+  simplify_exprt simplifier;
+
+  typedef std::unordered_map<
+    exprt, exprt, expr_store_hasht, expr_store_equalt> mapt;
+  mapt map;
+};
+
+#endif // CPROVER_PATH_SYMEX_SIMPLIFY_CACHE_H
@@ -20,7 +20,6 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <util/byte_operators.h>
 #include <util/pointer_offset_size.h>
 #include <util/base_type.h>
-#include <util/simplify_expr.h>
 #include <util/arith_tools.h>
 
 #include <util/c_types.h>
@@ -40,10 +39,56 @@ exprt symex_dereferencet::operator()(const exprt &pointer)
   std::cout << "DEREF: " << format(pointer) << '\n';
   #endif
 
-  return dereference_rec(
-    pointer,
+  // the result only depends on the pointer
+  const exprt &key=expr_store(pointer);
+
+  resultst::const_iterator it=results.find(key);
+
+  if(it!=results.end())
+  {
+    hits++;
+    return it->second;
+  }
+
+  misses++;
+
+  exprt result=dereference_rec(
+    key,
     from_integer(0, index_type()), // offset
     type);
+
+  if(results.size()>=max_size)
+    results.clear();
+
+  results.emplace(key, result);
+
+  return result;
+}
+
+const optionalt<exprt> &symex_dereferencet::size_of(const typet &type)
+{
+  size_of_cachet::const_iterator it=size_of_cache.find(type);
+
+  if(it!=size_of_cache.end())
+    return it->second;
+
+  return size_of_cache.emplace(type, size_of_expr(type, ns)).first->second;
+}
+
+const optionalt<exprt> &symex_dereferencet::member_offset_of(
+  const struct_typet &struct_type,
+  const irep_idt &component_name)
+{
+  const member_keyt key{struct_type, component_name};
+
+  auto it=member_offset_cache.find(key);
+
+  if(it!=member_offset_cache.end())
+    return it->second;
+
+  return member_offset_cache.emplace(
+    key,
+    member_offset_expr(struct_type, component_name, ns)).first->second;
 }
 
 exprt symex_dereferencet::read_object(
@@ -56,7 +101,7 @@ exprt symex_dereferencet::read_object(
 
   // is the object an array with matching subtype?
 
-  exprt simplified_offset=simplify_expr(offset, ns);
+  exprt simplified_offset=simplify(offset);
 
   // check if offset is zero
   if(simplified_offset.is_zero())
@@ -80,7 +125,7 @@ exprt symex_dereferencet::read_object(
     exprt index=index_expr.index();
 
     // multiply index by object size
-    auto size_opt=size_of_expr(object_type, ns);
+    const auto &size_opt=size_of(object_type);
 
     if(!size_opt.has_value())
       throw "dereference failed to get object size for index";
@@ -104,8 +149,8 @@ exprt symex_dereferencet::read_object(
       const struct_typet &struct_type=
         to_struct_type(compound_type);
 
-      auto member_offset_opt=member_offset_expr(
-        struct_type, member_expr.get_component_name(), ns);
+      const auto &member_offset_opt=member_offset_of(
+        struct_type, member_expr.get_component_name());
 
       if(!member_offset_opt.has_value())
         throw "dereference failed to get member offset";
@@ -130,11 +175,11 @@ exprt symex_dereferencet::read_object(
      base_type_eq(object_type.subtype(), dest_type, ns))
   {
     // check proper alignment
-    auto element_size_opt=size_of_expr(dest_type, ns);
+    const auto &element_size_opt=size_of(dest_type);
 
     if(element_size_opt.has_value())
     {
-      const exprt element_size_simplified = simplify_expr(*element_size_opt, ns);
+      const exprt element_size_simplified = simplify(*element_size_opt);
     
       // the offset must be a multiple of the element size
       mp_integer element_size_constant, offset_constant;
@@ -280,7 +325,7 @@ exprt symex_dereferencet::dereference_plus(
     std::swap(pointer, integer);
 
   // multiply integer by object size
-  const auto size_opt=size_of_expr(pointer.type().subtype(), ns);
+  const auto &size_opt=size_of(pointer.type().subtype());
   if(!size_opt.has_value())
     throw "dereference failed to get object size for pointer arithmetic";
 
@@ -324,6 +369,23 @@ exprt symex_dereferencet::dereference_typecast(
 }
 
 bool symex_dereferencet::type_compatible(
+  const typet &object_type,
+  const typet &dereference_type)
+{
+  auto key=std::make_pair(object_type, dereference_type);
+
+  auto it=type_compatible_cache.find(key);
+
+  if(it!=type_compatible_cache.end())
+    return it->second;
+
+  const bool result=type_compatible_rec(object_type, dereference_type);
+  type_compatible_cache.emplace(std::move(key), result);
+
+  return result;
+}
+
+bool symex_dereferencet::type_compatible_rec(
   const typet &object_type,
   const typet &dereference_type) const
 {
@@ -12,27 +12,42 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_SYMEX_DEREFERENCE_H
 #define CPROVER_SYMEX_DEREFERENCE_H
 
+#include <unordered_map>
+#include <utility>
+
 #include <util/namespace.h>
 #include <util/expr.h>
+#include <util/irep_hash.h>
+#include <util/optional.h>
+
+#include "expr_store.h"
+#include "simplify_cache.h"
 
 class if_exprt;
 class typecast_exprt;
+class struct_typet;
 
-/*! \brief TO_BE_DOCUMENTED
-*/
+/// Dereferences pointers that have been propagated by the read
+/// pipeline. A single instance lives for the whole run, and
+/// remembers the object layouts and the dereferenced addresses
+/// it has computed, as both only depend on the program.
 class symex_dereferencet
 {
 public:
   /*! \brief Constructor
    * \param _ns Namespace
-   * \param _new_symbol_table A symbol_table to store new symbols in
-   * \param _options Options, in particular whether pointer checks are
-            to be performed
-   * \param _dereference_callback Callback object for error reporting
+   * \param _expr_store Expression store, to key the result cache
+   * \param _simplify Simplifier with cache, shared with the read pipeline
   */
-  explicit symex_dereferencet(
-    const namespacet &_ns):
-    ns(_ns)
+  symex_dereferencet(
+    const namespacet &_ns,
+    expr_storet &_expr_store,
+    simplify_cachet &_simplify):
+    hits(0),
+    misses(0),
+    ns(_ns),
+    expr_store(_expr_store),
+    simplify(_simplify)
   {
   }
 
@@ -48,8 +63,96 @@ public:
 
   exprt operator()(const exprt &pointer);
 
+  std::size_t size() const
+  {
+    return results.size()+size_of_cache.size()+
+           member_offset_cache.size()+type_compatible_cache.size();
+  }
+
+  /// forgets the dereferenced addresses, but not the layouts,
+  /// which do not refer to the expression store
+  void clear_results()
+  {
+    results.clear();
+  }
+
+  // statistics
+  std::size_t hits, misses;
+
+  // we clear the result cache when it gets bigger than this
+  static const std::size_t max_size=1<<16;
+
 private:
   const namespacet &ns;
+  expr_storet &expr_store;
+  simplify_cachet &simplify;
+
+  // keyed by the store-canonical pointer
+  typedef std::unordered_map<
+    exprt, exprt, expr_store_hasht, expr_store_equalt> resultst;
+  resultst results;
+
+  typedef std::unordered_map<typet, optionalt<exprt>, irep_hash, irep_full_eq>
+    size_of_cachet;
+  size_of_cachet size_of_cache;
+
+  struct member_keyt
+  {
+    typet type;
+    irep_idt component_name;
+  };
+
+  struct member_key_hasht
+  {
+    std::size_t operator()(const member_keyt &key) const
+    {
+      return hash_combine(
+        irep_hash()(key.type), irep_id_hash()(key.component_name));
+    }
+  };
+
+  struct member_key_equalt
+  {
+    bool operator()(const member_keyt &a, const member_keyt &b) const
+    {
+      return a.component_name==b.component_name &&
+             irep_full_eq()(a.type, b.type);
+    }
+  };
+
+  std::unordered_map<
+    member_keyt, optionalt<exprt>, member_key_hasht, member_key_equalt>
+    member_offset_cache;
+
+  struct type_pair_hasht
+  {
+    std::size_t operator()(const std::pair<typet, typet> &pair) const
+    {
+      return hash_combine(irep_hash()(pair.first), irep_hash()(pair.second));
+    }
+  };
+
+  struct type_pair_equalt
+  {
+    bool operator()(
+      const std::pair<typet, typet> &a,
+      const std::pair<typet, typet> &b) const
+    {
+      return irep_full_eq()(a.first, b.first) &&
+             irep_full_eq()(a.second, b.second);
+    }
+  };
+
+  std::unordered_map<
+    std::pair<typet, typet>, bool, type_pair_hasht, type_pair_equalt>
+    type_compatible_cache;
+
+  // memoized size_of_expr and member_offset_expr
+  const optionalt<exprt> &size_of(const typet &);
+
+  const optionalt<exprt> &member_offset_of(
+    const struct_typet &,
+    const irep_idt &component_name);
 
   exprt dereference_rec(
     const exprt &address,
@@ -72,6 +175,10 @@ private:
     const typet &type);
 
   bool type_compatible(
+    const typet &object_type,
+    const typet &dereference_type);
+
+  bool type_compatible_rec(
     const typet &object_type,
     const typet &dereference_type) const;
 
@@ -85,10 +192,4 @@ private:
     const typet &type);
 };
 
-inline exprt symex_dereference(const exprt &pointer, const namespacet &ns)
-{
-  symex_dereferencet dereference_object(ns);
-  return dereference_object(pointer);
-}
-
 #endif // CPROVER_SYMEX_DEREFERENCE_H
@@ -11,30 +11,99 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "var_map.h"
 
+#include <cstdint>
+#include <limits>
 #include <ostream>
+#include <unordered_map>
 
+#include <util/arith_tools.h>
 #include <util/symbol.h>
 #include <util/std_expr.h>
 #include <util/prefix.h>
 
-irep_idt ID_C_full_identifier;
+const irep_idt ID_C_full_identifier("#full_identifier");
+
+/// \return the interned decimal representation of \p version;
+///   these are shared by all variables, and built once per number
+static const irep_idt &version_id(unsigned version)
+{
+  static std::vector<irep_idt> ids;
+
+  while(ids.size()<=version)
+    ids.push_back(std::to_string(ids.size()));
+
+  return ids[version];
+}
 
 symbol_exprt var_mapt::var_infot::ssa_symbol() const
 {
-  symbol_exprt s=symbol_exprt(ssa_identifier(), original.type());
-  s.set(ID_C_SSA_symbol, true);
-  s.set(ID_C_full_identifier, full_identifier);
+  // the template shares identifier, type and annotations
+  symbol_exprt s=ssa_template;
+  s.set(ID_L2, version_id(ssa_counter));
   return s;
 }
 
+irep_idt ssa_name(const symbol_exprt &symbol_expr)
+{
+  if(!symbol_expr.get_bool(ID_C_SSA_symbol))
+    return symbol_expr.get_identifier();
+
+  // memoized, as the solver asks for every occurrence
+  static std::unordered_map<std::uint64_t, irep_idt> names;
+
+  const irep_idt &identifier=symbol_expr.get_identifier();
+  const irep_idt &version=symbol_expr.get(ID_L2);
+  const std::uint64_t key=
+    (std::uint64_t(identifier.get_no())<<32)|version.get_no();
+
+  const auto entry=names.emplace(key, irep_idt());
+  if(entry.second)
+    entry.first->second=id2string(identifier)+"#"+id2string(version);
+
+  return entry.first->second;
+}
+
+exprt name_ssa_symbols(const exprt &src)
+{
+  if(src.id()==ID_symbol)
+  {
+    if(!src.get_bool(ID_C_SSA_symbol))
+      return src;
+
+    symbol_exprt result=to_symbol_expr(src);
+    result.set_identifier(ssa_name(result));
+    result.remove(ID_L2);
+    return result;
+  }
+
+  if(!src.has_operands())
+    return src;
+
+  exprt result=src;
+
+  for(auto &op : result.operands())
+    op=name_ssa_symbols(op);
+
+  return result;
+}
+
+void var_mapt::var_infot::set_original(const exprt &_original)
+{
+  original=_original;
+  ssa_template=symbol_exprt(full_identifier, original.type());
+  ssa_template.set(ID_C_SSA_symbol, true);
+  ssa_template.set(ID_C_full_identifier, full_identifier);
+}
+
 var_mapt::var_mapt(const namespacet &_ns):
   ns(_ns.get_symbol_table(), new_symbols),
   shared_count(0),
   local_count(0),
+  used_slots(0),
   nondet_count(0),
-  dynamic_count(0)
+  dynamic_count(0),
+  max_array_expansion(std::numeric_limits<std::size_t>::max())
 {
-  ID_C_full_identifier="#full_identifier";
 }
 
 var_mapt::var_infot &var_mapt::operator()(
@@ -44,24 +113,82 @@ var_mapt::var_infot &var_mapt::operator()(
 {
   assert(!symbol.empty());
 
-  std::string full_identifier=
-    id2string(symbol)+id2string(suffix);
+  if(!slots.empty())
+  {
+    const std::size_t mask=slots.size()-1;
 
-  std::pair<id_mapt::iterator, bool> result;
+    for(std::size_t i=hash(symbol, suffix)&mask;
+        slots[i].id!=0;
+        i=(i+1)&mask)
+    {
+      if(slots[i].symbol==symbol && slots[i].suffix==suffix)
+        return vars[slots[i].id-1]; // found
+    }
+  }
 
-  result=id_map.insert(std::pair<irep_idt, var_infot>(
-    full_identifier, var_infot()));
+  // We only build the full identifier for new splits.
+  std::string full_identifier=
+    id2string(symbol)+id2string(suffix);
 
-  if(result.second) // inserted?
+  // Different splits into symbol and suffix may
+  // yield the same full identifier; the split is
+  // remembered such that it is found in the slots.
+  var_infot *existing=find(full_identifier);
+  if(existing!=nullptr)
   {
-    result.first->second.full_identifier=full_identifier;
-    result.first->second.symbol=symbol;
-    result.first->second.suffix=suffix;
-    result.first->second.original=original;
-    init(result.first->second);
+    insert_slot(symbol, suffix, existing->id);
+    return *existing;
   }
 
-  return result.first->second;
+  vars.push_back(var_infot());
+  var_infot &var_info=vars.back();
+
+  var_info.id=vars.size()-1;
+  var_info.full_identifier=full_identifier;
+  var_info.symbol=symbol;
+  var_info.suffix=suffix;
+  var_info.set_original(original);
+  init(var_info);
+
+  by_full_identifier[var_info.full_identifier]=var_info.id;
+  by_symbol[symbol].push_back(var_info.id);
+
+  insert_slot(symbol, suffix, var_info.id);
+
+  return var_info;
+}
+
+void var_mapt::insert_slot(
+  const irep_idt &symbol,
+  const irep_idt &suffix,
+  unsigned id)
+{
+  // keep the load factor at most 1/2
+  if((used_slots+1)*2>slots.size())
+    grow_slots();
+
+  const std::size_t mask=slots.size()-1;
+  std::size_t i=hash(symbol, suffix)&mask;
+
+  while(slots[i].id!=0)
+    i=(i+1)&mask;
+
+  slots[i].symbol=symbol;
+  slots[i].suffix=suffix;
+  slots[i].id=id+1;
+  used_slots++;
+}
+
+void var_mapt::grow_slots()
+{
+  slotst old_slots;
+  old_slots.swap(slots);
+  slots.resize(old_slots.empty()?1024:old_slots.size()*2);
+  used_slots=0;
+
+  for(const auto &slot : old_slots)
+    if(slot.id!=0)
+      insert_slot(slot.symbol, slot.suffix, slot.id-1);
 }
 
 void var_mapt::var_infot::output(std::ostream &out) const
@@ -82,6 +209,7 @@ void var_mapt::var_infot::output(std::ostream &out) const
   out << "\n";
 
   out << "number: " << number << "\n";
+  out << "id: " << id << "\n";
 
   out << "original: " << original.pretty() << "\n";
 
@@ -136,30 +264,45 @@ void var_mapt::init(var_infot &var_info)
     var_info.number=local_count++;
 }
 
-irep_idt var_mapt::var_infot::ssa_identifier() const
+std::size_t var_mapt::approx_memory() const
 {
-  return id2string(full_identifier)+
-         "#"+std::to_string(ssa_counter);
+  // rough size of a node of a std::unordered_map
+  const std::size_t map_node=4*sizeof(void *);
+
+  return vars.size()*sizeof(var_infot)+
+         by_full_identifier.size()*(map_node+sizeof(unsigned))+
+         by_symbol.size()*(map_node+sizeof(std::vector<unsigned>))+
+         vars.size()*sizeof(unsigned)+
+         slots.capacity()*sizeof(slott);
+}
+
+std::size_t var_mapt::approx_new_symbols_memory() const
+{
+  // the symbols are kept in a map, and are indexed
+  // by base name and module
+  return new_symbols.symbols.size()*(sizeof(symbolt)+12*sizeof(void *));
 }
 
 void var_mapt::output(std::ostream &out) const
 {
-  for(id_mapt::const_iterator
-      it=id_map.begin();
-      it!=id_map.end();
-      it++)
+  for(const auto &var_info : vars)
   {
-    out << it->first << ":\n";
-    it->second.output(out);
+    out << var_info.full_identifier << ":\n";
+    var_info.output(out);
   }
 }
 
-bool var_mapt::is_unbounded_array(const array_typet &type)
+bool var_mapt::is_unbounded_array(const array_typet &type) const
 {
-  return !type.size().is_constant();
+  if(!type.size().is_constant())
+    return true;
+
+  const auto size=numeric_cast<std::size_t>(to_constant_expr(type.size()));
+
+  return !size.has_value() || *size>max_array_expansion;
 }
 
-bool var_mapt::is_unbounded_array(const typet &type)
+bool var_mapt::is_unbounded_array(const typet &type) const
 {
   if(type.id()==ID_array)
     return is_unbounded_array(to_array_type(type));
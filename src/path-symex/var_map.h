@@ -12,15 +12,19 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_PATH_SYMEX_VAR_MAP_H
 #define CPROVER_PATH_SYMEX_VAR_MAP_H
 
+#include <deque>
 #include <iosfwd>
-#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <util/invariant.h>
 #include <util/namespace.h>
 #include <util/type.h>
 #include <util/std_expr.h>
 #include <util/symbol_table.h>
 
-extern irep_idt ID_C_full_identifier;
+extern const irep_idt ID_C_full_identifier;
 
 class var_mapt
 {
@@ -36,9 +40,13 @@ public:
       return kind==SHARED;
     }
 
-    // the variables are numbered
+    // the variables are numbered, separately for shared
+    // and local variables
     unsigned number;
 
+    // dense numbering of all variables
+    unsigned id;
+
     // full_identifier=symbol+suffix
     irep_idt full_identifier, symbol, suffix;
 
@@ -47,32 +55,82 @@ public:
 
     unsigned ssa_counter;
 
-    var_infot():kind(SHARED), number(0), ssa_counter(0)
+    var_infot():
+      kind(SHARED),
+      number(0),
+      id(0),
+      ssa_counter(0),
+      ssa_template(irep_idt(), typet())
     {
     }
 
-    irep_idt ssa_identifier() const;
+    // The SSA symbol of the current version. Its identifier is
+    // the full identifier, and the version is held as ID_L2,
+    // such that no name needs to be built; see ssa_name.
     symbol_exprt ssa_symbol() const;
 
+    void set_original(const exprt &);
+
     void increment_ssa_counter()
     {
       ++ssa_counter;
     }
 
     void output(std::ostream &out) const;
-  };
 
-  typedef std::map<irep_idt, var_infot> id_mapt;
-  id_mapt id_map;
+  protected:
+    // SSA symbols of this variable only differ in their identifier
+    symbol_exprt ssa_template;
+  };
 
+  /// \return the variable for the given symbol and suffix,
+  ///   which is created if needed; the reference is stable
   var_infot &operator()(
     const irep_idt &symbol,
     const irep_idt &suffix,
     const exprt &original);
 
-  var_infot &operator[](const irep_idt &full_identifier)
+  /// \return the variable with the given full identifier,
+  ///   or nullptr if there is none
+  var_infot *find(const irep_idt &full_identifier)
   {
-    return id_map[full_identifier];
+    const auto it=by_full_identifier.find(full_identifier);
+    return it==by_full_identifier.end()?nullptr:&vars[it->second];
+  }
+
+  /// \return the variable of the given SSA symbol; the interned
+  ///   full identifier the symbol carries is the handle
+  var_infot &from_ssa(const symbol_exprt &ssa_symbol)
+  {
+    var_infot *var_info=find(ssa_symbol.get(ID_C_full_identifier));
+    INVARIANT(var_info!=nullptr, "SSA symbol must have a variable");
+    return *var_info;
+  }
+
+  /// \return the ids of the variables of the given symbol,
+  ///   one per suffix
+  const std::vector<unsigned> &of_symbol(const irep_idt &symbol) const
+  {
+    static const std::vector<unsigned> none;
+    const auto it=by_symbol.find(symbol);
+    return it==by_symbol.end()?none:it->second;
+  }
+
+  var_infot &operator[](unsigned id)
+  {
+    PRECONDITION(id<vars.size());
+    return vars[id];
+  }
+
+  const var_infot &operator[](unsigned id) const
+  {
+    PRECONDITION(id<vars.size());
+    return vars[id];
+  }
+
+  std::size_t size() const
+  {
+    return vars.size();
   }
 
   void clear()
@@ -81,7 +139,11 @@ public:
     local_count=0;
     nondet_count=0;
     dynamic_count=0;
-    id_map.clear();
+    vars.clear();
+    by_full_identifier.clear();
+    by_symbol.clear();
+    slots.clear();
+    used_slots=0;
   }
 
   void init(var_infot &var_info);
@@ -91,15 +153,81 @@ public:
 
   void output(std::ostream &) const;
 
+  // approximate number of bytes held by the variables
+  // and by the symbols we have added
+  std::size_t approx_memory() const;
+  std::size_t approx_new_symbols_memory() const;
+
 protected:
   unsigned shared_count, local_count;
 
+  // indexed by var_infot::id, references are stable
+  typedef std::deque<var_infot> varst;
+  varst vars;
+
+  // the var_infot::id of each full identifier
+  std::unordered_map<irep_idt, unsigned, irep_id_hash> by_full_identifier;
+
+  // the var_infot::ids of each symbol
+  std::unordered_map<irep_idt, std::vector<unsigned>, irep_id_hash>
+    by_symbol;
+
+  // Open addressing with linear probing on (symbol, suffix),
+  // which avoids building the full identifier for lookups.
+  // A variable may have several slots, one per split of its
+  // full identifier. The slots hold var_infot::id+1 as id,
+  // or 0 for empty slots. The number of slots is a power of two.
+  struct slott
+  {
+    irep_idt symbol, suffix;
+    unsigned id;
+
+    slott():id(0)
+    {
+    }
+  };
+
+  typedef std::vector<slott> slotst;
+  slotst slots;
+  std::size_t used_slots;
+
+  static std::size_t hash(const irep_idt &symbol, const irep_idt &suffix)
+  {
+    return (std::size_t(symbol.get_no())*2654435761u)^suffix.get_no();
+  }
+
+  void insert_slot(
+    const irep_idt &symbol,
+    const irep_idt &suffix,
+    unsigned id);
+  void grow_slots();
+
 public:
   unsigned nondet_count;  // free inputs
   unsigned dynamic_count; // memory allocation
 
-  static bool is_unbounded_array(const array_typet &);
-  static bool is_unbounded_array(const typet &);
+  // Arrays with more elements are not expanded into their
+  // elements, but are treated like arrays of unbounded size.
+  std::size_t max_array_expansion;
+
+  // arrays that are kept as a whole, updated using 'with'
+  bool is_unbounded_array(const array_typet &) const;
+  bool is_unbounded_array(const typet &) const;
 };
 
+/// SSA symbols are told apart by their identifier and their version
+typedef std::pair<irep_idt, irep_idt> ssa_keyt;
+
+inline ssa_keyt ssa_key(const symbol_exprt &symbol_expr)
+{
+  return ssa_keyt(symbol_expr.get_identifier(), symbol_expr.get(ID_L2));
+}
+
+/// \return full_identifier#version for SSA symbols, as needed by
+///   the solver and for output, and the identifier for other symbols
+irep_idt ssa_name(const symbol_exprt &);
+
+/// \return \p src with the SSA symbols renamed to their ssa_name
+exprt name_ssa_symbols(const exprt &src);
+
 #endif // CPROVER_PATH_SYMEX_VAR_MAP_H
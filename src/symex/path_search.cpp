@@ -11,17 +11,107 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include "path_search.h"
 
+#include <algorithm>
+
+#include <util/string2int.h>
+#include <util/string_utils.h>
+
 #include <solvers/flattening/bv_pointers.h>
 #include <solvers/sat/satcheck.h>
 
 #include <path-symex/path_symex.h>
 #include <path-symex/build_goto_trace.h>
 
+#include <goto-locs/post_dominators.h>
+
 path_searcht::resultt path_searcht::operator()(
   const goto_functionst &goto_functions)
 {
   path_symex_configt config(ns, goto_functions);
   config.set_message_handler(get_message_handler());
+  config.var_map.max_array_expansion=max_array_expansion;
+  config.propagation=propagation;
+  config.fused_read=fused_read;
+  config.time_reads=time_reads;
+  config.context_bound=context_bound;
+
+  // the loop bounds, densely
+  loop_bounds.assign(config.locs.loop_ids.size(), unwind_limit);
+
+  std::set<irep_idt> unused_unwindset;
+  for(const auto &entry : unwindset)
+    unused_unwindset.insert(entry.first);
+
+  for(std::size_t i=0; i<config.locs.loop_ids.size(); i++)
+  {
+    const auto it=unwindset.find(config.locs.loop_ids[i]);
+
+    if(it!=unwindset.end())
+    {
+      loop_bounds[i]=it->second;
+      unused_unwindset.erase(it->first);
+    }
+  }
+
+  for(const auto &id : unused_unwindset)
+    if(config.locs.function_map.find(id)==config.locs.function_map.end())
+      warning() << "--unwindset: no loop or function " << id << eom;
+
+  if(loop_acceleration)
+    config.loop_acceleration.build(config.locs);
+
+  if(function_summaries)
+    config.summaries.enable();
+
+  // the paths of a branch join at its immediate post-dominator
+  merge_points.assign(merge_states?config.locs.size():0, false);
+
+  if(merge_states)
+  {
+    const post_dominatorst post_dominators(config.locs);
+
+    for(loc_reft l=config.locs.begin(); l!=config.locs.end(); ++l)
+    {
+      const loct &loc=config.locs[l];
+
+      if(loc.type==GOTO &&
+         !loc.target->get_condition().is_true() &&
+         post_dominators[l].is_not_nil())
+        merge_points[post_dominators[l].loc_number]=true;
+    }
+  }
+
+  // states that cannot reach an assertion are of no use,
+  // unless they may fail an unwinding assertion
+  if(unwinding_assertions)
+    property_reachability.reset();
+  else
+  {
+    property_reachability.reset(new property_reachabilityt(config.locs));
+    reachability_failed_properties=std::numeric_limits<std::size_t>::max();
+  }
+
+  join_points.assign(drop_duplicate_states?config.locs.size():0, false);
+
+  if(drop_duplicate_states)
+  {
+    for(loc_reft l=config.locs.begin(); l!=config.locs.end(); ++l)
+    {
+      const loct &loc=config.locs[l];
+
+      if(loc.type==GOTO)
+        join_points[loc.branch_target.loc_number]=true;
+    }
+  }
+
+  if(points_to_analysis)
+  {
+    status() << "Running points-to analysis" << eom;
+    config.points_to(goto_functions);
+
+    if(!config.points_to.is_enabled())
+      warning() << "points-to analysis is inconclusive, not using it" << eom;
+  }
 
   status() << "Starting symbolic simulation" << eom;
 
@@ -29,11 +119,9 @@ path_searcht::resultt path_searcht::operator()(
   path_symex_historyt history;
 
   queue.push_back(config.initial_state());
+  held.clear();
 
-  // count locs
-  std::size_t loc_count = 0;
-  for(auto &f : goto_functions.function_map)
-    loc_count += f.second.body.instructions.size();
+  loc_data.assign(config.locs.size(), loc_datat());
 
   // set up the statistics
   number_of_dropped_states=0;
@@ -43,8 +131,16 @@ path_searcht::resultt path_searcht::operator()(
   number_of_feasible_paths=0;
   number_of_infeasible_paths=0;
   number_of_VCCs_after_simplification=0;
+  number_of_solver_variables=0;
+  number_of_solver_clauses=0;
   number_of_failed_properties=0;
-  number_of_locs=loc_count;
+  number_of_locs=config.locs.size();
+  number_of_memory_dropped_states=0;
+  number_of_merged_states=0;
+  number_of_duplicate_states=0;
+  number_of_unreaching_states=0;
+  peak_memory=0;
+  last_memory=0;
 
   // stop the time
   start_time=std::chrono::steady_clock::now();
@@ -52,10 +148,27 @@ path_searcht::resultt path_searcht::operator()(
 
   initialize_property_map(goto_functions);
 
-  while(!queue.empty())
+  // the entries of the properties of the assertions, by property index
+  property_entries.clear();
+  for(const auto &property_id : config.locs.property_ids)
+    property_entries.push_back(&property_map[property_id]);
+
+  while(!queue.empty() || !held.empty())
   {
     number_of_steps++;
 
+    // the held states continue once there is nothing else to do
+    const bool released=queue.empty();
+    if(released)
+      queue.splice(queue.begin(), held, held.begin());
+
+    // no reads are in progress between steps
+    config.bound_caches();
+
+    // we measure the memory every now and then
+    if(number_of_steps%100==0)
+      check_memory(config);
+
     // Pick a state from the queue,
     // according to some heuristic.
     // The state moves to the head of the queue.
@@ -71,7 +184,7 @@ path_searcht::resultt path_searcht::operator()(
       statet &state=tmp_queue.front();
 
       // record we have seen it
-      loc_data[state.pc()].visited=true;
+      loc_data[state.pc().loc_number].visited=true;
 
       debug() << "Loc: " << state.pc()
               << ", queue: " << queue.size()
@@ -101,6 +214,26 @@ path_searcht::resultt path_searcht::operator()(
         continue;
       }
 
+      // no property left to fail on this path?
+      if(property_reachability && !may_reach_open_property(state))
+      {
+        number_of_unreaching_states++;
+        number_of_paths++;
+        continue;
+      }
+
+      // Seen before on another path? With threads, the paths
+      // meet again wherever independent steps are reordered.
+      if(drop_duplicate_states &&
+         !released &&
+         (join_points[state.pc().loc_number] || state.threads.size()>1) &&
+         is_duplicate(state))
+      {
+        number_of_duplicate_states++;
+        number_of_paths++;
+        continue;
+      }
+
       // check feasibility
       if(eager_infeasibility &&
          state.last_was_branch() &&
@@ -123,14 +256,33 @@ path_searcht::resultt path_searcht::operator()(
                    << '/' << state.threads.size()
                    << " PC " << state.pc()
                    << " depth " << state.get_depth()
+                   << " mem " << last_memory/(1024*1024) << " MiB"
                    << " [" << number_of_steps << " steps, "
                    << std::chrono::duration<double>(running_time).count()
                    << "s]" << messaget::eom;
         }
       }
 
+      // wait at a join point for other states to merge with
+      if(merge_states &&
+         !released &&
+         merge_points[state.pc().loc_number])
+      {
+        if(merge(state))
+        {
+          number_of_merged_states++;
+          continue;
+        }
+
+        if(!queue.empty())
+        {
+          held.splice(held.end(), tmp_queue);
+          continue;
+        }
+      }
+
       // an error, possibly?
-      if(state.get_instruction()->is_assert())
+      if(state.get_loc().type==ASSERT)
       {
         if(show_vcc)
           do_show_vcc(state);
@@ -170,16 +322,16 @@ path_searcht::resultt path_searcht::operator()(
     }
   }
 
-  report_statistics();
+  report_statistics(config);
 
   return number_of_failed_properties==0?resultt::SAFE:resultt::UNSAFE;
 }
 
-void path_searcht::report_statistics()
+void path_searcht::report_statistics(const path_symex_configt &config)
 {
   std::size_t number_of_visited_locations=0;
   for(const auto &l : loc_data)
-    if(l.second.visited)
+    if(l.visited)
       number_of_visited_locations++;
 
   #if 0
@@ -196,6 +348,22 @@ void path_searcht::report_statistics()
   status() << "Number of dropped states: "
            << number_of_dropped_states << messaget::eom;
 
+  if(memory_limit!=std::numeric_limits<std::size_t>::max())
+    status() << "Number of states dropped due to memory limit: "
+             << number_of_memory_dropped_states << messaget::eom;
+
+  if(merge_states)
+    status() << "Number of merged states: "
+             << number_of_merged_states << messaget::eom;
+
+  if(drop_duplicate_states)
+    status() << "Number of duplicate states: "
+             << number_of_duplicate_states << messaget::eom;
+
+  if(property_reachability)
+    status() << "Number of states that cannot reach an open property: "
+             << number_of_unreaching_states << messaget::eom;
+
   status() << "Number of paths: "
            << number_of_paths << messaget::eom;
 
@@ -207,6 +375,68 @@ void path_searcht::report_statistics()
            << " remaining after simplification"
            << messaget::eom;
 
+  const expr_storet &expr_store=config.expr_store;
+  status() << "Expression store: " << expr_store.size()
+           << " unique expressions, " << expr_store.hits << " hits, "
+           << expr_store.shared_nodes << " shared nodes (an estimated "
+           << expr_store.shared_nodes*expr_storet::node_size()/1024
+           << " KiB saved), " << expr_store.clears << " clears"
+           << messaget::eom;
+
+  status() << "Approximate memory: peak "
+           << std::max(peak_memory, approx_memory(config))/1024
+           << " KiB; history "
+           << config.path_symex_history.approx_memory()/1024
+           << " KiB, variables "
+           << config.var_map.approx_memory()/1024
+           << " KiB, new symbols "
+           << config.var_map.approx_new_symbols_memory()/1024
+           << " KiB" << messaget::eom;
+
+  const read_cachet &read_cache=config.read_cache;
+  status() << "Read cache: " << read_cache.hits << " hits, "
+           << read_cache.misses << " misses, "
+           << read_cache.invalidated << " invalidated" << messaget::eom;
+
+  const simplify_cachet &simplify=config.simplify;
+  status() << "Simplifier cache: " << simplify.hits << " hits, "
+           << simplify.misses << " misses";
+  if(simplify.hits+simplify.misses!=0)
+    status() << " (" << simplify.hits*100/(simplify.hits+simplify.misses)
+             << "% hit rate)";
+  status() << messaget::eom;
+
+  status() << "Formula size: " << number_of_solver_variables
+           << " variables, " << number_of_solver_clauses
+           << " clauses" << messaget::eom;
+
+  if(config.loop_acceleration.is_enabled())
+    status() << "Loop acceleration: "
+             << config.loop_acceleration.accelerated << " loops, "
+             << config.loop_acceleration.saved_iterations
+             << " iterations" << messaget::eom;
+
+  if(config.summaries.is_enabled())
+    status() << "Function summaries: "
+             << config.summaries.recorded << " recorded, "
+             << config.summaries.replayed << " replayed" << messaget::eom;
+
+  if(config.context_switches+config.pruned_context_switches!=0)
+    status() << "Context switches: "
+             << config.context_switches << " explored, "
+             << config.pruned_context_switches << " pruned" << messaget::eom;
+
+  status() << "Branches decided by intervals: "
+           << config.decided_branches << messaget::eom;
+
+  const symex_dereferencet &dereference=config.dereference;
+  status() << "Dereference cache: " << dereference.hits << " hits, "
+           << dereference.misses << " misses" << messaget::eom;
+
+  if(config.points_to.is_enabled())
+    status() << "Points-to analysis: " << config.points_to.resolved
+             << " pointers resolved" << messaget::eom;
+
   auto total_time=std::chrono::steady_clock::now()-start_time;
   status() << "Runtime total: "
            << std::chrono::duration<double>(total_time).count()
@@ -214,6 +444,80 @@ void path_searcht::report_statistics()
               "Runtime decision procedure: "
            << std::chrono::duration<double>(solver_time).count()
            << "s" << messaget::eom;
+
+  if(config.time_reads)
+    status() << "Runtime read"
+             << (config.fused_read?" (fused)":"") << ": "
+             << config.read_time.count()
+             << "s" << messaget::eom;
+}
+
+/// approximate memory use of the queue and the shared data structures
+std::size_t path_searcht::approx_memory(
+  const path_symex_configt &config) const
+{
+  std::size_t result=
+    config.path_symex_history.approx_memory()+
+    config.var_map.approx_memory()+
+    config.var_map.approx_new_symbols_memory()+
+    config.expr_store.approx_memory();
+
+  for(const auto &state : queue)
+    result+=state.approx_memory();
+
+  for(const auto &state : held)
+    result+=state.approx_memory();
+
+  for(const auto &visited : visited_states)
+    result+=visited.second.approx_memory();
+
+  return result;
+}
+
+/// measure memory, and drop states of lowest priority
+/// if we exceed the limit given with --max-memory
+void path_searcht::check_memory(path_symex_configt &config)
+{
+  last_memory=approx_memory(config);
+  peak_memory=std::max(peak_memory, last_memory);
+
+  if(last_memory<=memory_limit)
+    return;
+
+  // the caches can be rebuilt, the states cannot, and
+  // forgetting the visited states only costs duplicates
+  if(config.expr_store.size()!=0 || !visited_states.empty())
+  {
+    config.clear_caches();
+    visited_states.clear();
+    last_memory=approx_memory(config);
+
+    if(last_memory<=memory_limit)
+      return;
+  }
+
+  if(number_of_memory_dropped_states==0)
+    warning() << "memory limit exceeded, dropping states" << eom;
+
+  // We keep one state, to make progress. The held states are
+  // dropped last, as others may still merge into them. The history
+  // and the variables are shared between all states, and are not freed.
+  while(last_memory>memory_limit && queue.size()+held.size()>1)
+  {
+    queuet &victims=queue.size()>1?queue:held;
+
+    // The BFS picks from the back, the others from the front.
+    queuet::iterator victim=
+      &victims==&queue && search_heuristic==search_heuristict::BFS?
+        victims.begin():--victims.end();
+
+    last_memory-=victim->approx_memory();
+    victims.erase(victim);
+
+    number_of_memory_dropped_states++;
+    number_of_dropped_states++;
+    number_of_paths++;
+  }
 }
 
 void path_searcht::pick_state()
@@ -236,10 +540,116 @@ void path_searcht::pick_state()
   }
 }
 
+/// merges the state into a held state at the same location
+/// \return true if successful
+bool path_searcht::merge(const statet &state)
+{
+  for(auto &h : held)
+    if(h.pc()==state.pc() && path_symex_merge(h, state))
+      return true;
+
+  return false;
+}
+
+void path_searcht::set_unwindset(const std::string &s)
+{
+  std::vector<std::string> entries;
+  split_string(s, ',', entries, true, true);
+
+  for(const auto &entry : entries)
+  {
+    const std::string::size_type colon=entry.rfind(':');
+
+    if(colon==std::string::npos || colon==0)
+      throw "--unwindset expects id:bound, but got `"+entry+"'";
+
+    unwindset[entry.substr(0, colon)]=
+      safe_string2unsigned(entry.substr(colon+1));
+  }
+}
+
+/// \return whether a thread of the state, or one of the functions
+///   it returns to, may reach an assertion that has not failed yet
+bool path_searcht::may_reach_open_property(const statet &state)
+{
+  if(reachability_failed_properties!=number_of_failed_properties)
+  {
+    std::vector<bool> open;
+    open.reserve(property_entries.size());
+
+    for(const auto entry : property_entries)
+      open.push_back(!entry->is_failure());
+
+    property_reachability->update(open);
+    reachability_failed_properties=number_of_failed_properties;
+  }
+
+  for(const auto &thread : state.threads)
+  {
+    if(!thread.active)
+      continue;
+
+    if((*property_reachability)[thread.pc])
+      return true;
+
+    for(const auto &frame : thread.call_stack)
+      if((*property_reachability)[frame.return_location])
+        return true;
+  }
+
+  return false;
+}
+
+/// \return whether a state seen before at a join point is the same
+///   as \p state, with no less room to go; if not, \p state is
+///   remembered
+bool path_searcht::is_duplicate(const statet &state)
+{
+  const std::size_t fingerprint=state.fingerprint();
+  const auto range=visited_states.equal_range(fingerprint);
+
+  for(auto it=range.first; it!=range.second; it++)
+    if(has_less_room(state, it->second) && state.same_as(it->second))
+      return true;
+
+  visited_states.emplace(fingerprint, state);
+
+  return false;
+}
+
+/// \return whether the bounds of the search leave \p state no more
+///   room than \p visited, such that \p state cannot get anywhere
+///   \p visited could not
+bool path_searcht::has_less_room(
+  const statet &state,
+  const statet &visited) const
+{
+  const unsigned none=std::numeric_limits<unsigned>::max();
+
+  if(depth_limit!=none && state.get_depth()<visited.get_depth())
+    return false;
+
+  if(branch_bound!=none && state.get_no_branches()<visited.get_no_branches())
+    return false;
+
+  if(context_bound!=none &&
+     state.get_no_thread_interleavings()<
+       visited.get_no_thread_interleavings())
+    return false;
+
+  for(std::size_t l=0; l<loop_bounds.size(); l++)
+    if(loop_bounds[l]!=none &&
+       state.get_unwinding(l)<visited.get_unwinding(l))
+      return false;
+
+  return true;
+}
+
 /// decide whether to drop an overwise viable state
 bool path_searcht::drop_state(const statet &state)
 {
-  goto_programt::const_targett pc=state.get_instruction();
+  const loct &loc=state.get_loc();
+  goto_programt::const_targett pc=loc.target;
 
   const source_locationt &source_location=pc->source_location;
 
@@ -258,34 +668,23 @@ bool path_searcht::drop_state(const statet &state)
   if(state.get_depth()>=depth_limit)
     return true;
 
-  // context bound
-  if(state.get_no_thread_interleavings()>=context_bound)
-    return true;
-
   // branch bound
   if(state.get_no_branches()>=branch_bound)
     return true;
 
   // unwinding limit -- loops
-  if(unwind_limit!=std::numeric_limits<unsigned>::max() &&
-     pc->is_backwards_goto())
+  if(loc.backwards_goto &&
+     loop_bounds[loc.loop_index]!=std::numeric_limits<unsigned>::max())
   {
-    bool stop=false;
+    const unsigned bound=loop_bounds[loc.loop_index];
+    const unsigned unwinding=state.get_unwinding(loc.loop_index);
+    const bool stop=unwinding>=bound;
 
-    for(const auto &loop_info : state.unwinding_map)
-      if(loop_info.second>=unwind_limit)
-      {
-        stop=true;
-        break;
-      }
-
-    const irep_idt id=goto_programt::loop_id(state.function_id(), *pc);
-    path_symex_statet::unwinding_mapt::const_iterator entry=
-      state.unwinding_map.find(state.pc());
+    const irep_idt &id=loc.loop_id;
     debug() << (stop?"Not unwinding":"Unwinding")
       << " loop " << id << " iteration "
-      << (entry==state.unwinding_map.end()?1:entry->second)
-      << " (" << unwind_limit << " max)"
+      << (unwinding==0?1:unwinding)
+      << " (" << bound << " max)"
       << " " << source_location
       << " thread " << state.get_current_thread() << eom;
 
@@ -293,7 +692,7 @@ bool path_searcht::drop_state(const statet &state)
     {
       // record that failure
       status() << "Unwinding assertion failed: " << id << eom;
-      irep_idt property=id2string(state.function_id())+".unwind."+
+      irep_idt property=id2string(loc.function_identifier)+".unwind."+
                         std::to_string(pc->loop_number);
       auto &p=property_map[property];
       if(p.description.empty())
@@ -310,8 +709,9 @@ bool path_searcht::drop_state(const statet &state)
   }
 
   // unwinding limit -- recursion
-  if(unwind_limit!=std::numeric_limits<unsigned>::max() &&
-     pc->is_function_call())
+  if(loc.type==FUNCTION_CALL &&
+     (unwind_limit!=std::numeric_limits<unsigned>::max() ||
+      !unwindset.empty()))
   {
     exprt function=to_code_function_call(pc->code).function();
     const irep_idt id=function.get(ID_identifier); // could be nil
@@ -321,12 +721,13 @@ bool path_searcht::drop_state(const statet &state)
     if(entry!=state.recursion_map.end() &&
        entry->second!=0)
     {
-      const bool stop=entry->second>=unwind_limit;
+      const unsigned bound=get_recursion_bound(id);
+      const bool stop=entry->second>=bound;
 
       debug() << (stop?"Not unwinding":"Unwinding")
         << " recursion " << id << " iteration "
         << entry->second+1
-        << " (" << unwind_limit << " max)"
+        << " (" << bound << " max)"
         << " " << source_location
         << " thread " << state.get_current_thread() << eom;
 
@@ -345,16 +746,17 @@ bool path_searcht::drop_state(const statet &state)
 
 void path_searcht::check_assertion(statet &state)
 {
-  const goto_programt::instructiont &instruction=
-    *state.get_instruction();
+  const loct &loc=state.get_loc();
+  const goto_programt::instructiont &instruction=*loc.target;
 
-  PRECONDITION(instruction.is_assert());
+  PRECONDITION(loc.type==ASSERT);
 
   // keep statistics
   number_of_VCCs++;
 
-  irep_idt property_name=instruction.source_location.get_property_id();
-  property_entryt &property_entry=property_map[property_name];
+  const irep_idt &property_name=
+    state.config.locs.property_ids[loc.property_index];
+  property_entryt &property_entry=*property_entries[loc.property_index];
 
   if(property_entry.status==FAILURE)
     return; // already failed
@@ -379,7 +781,12 @@ void path_searcht::check_assertion(statet &state)
   satcheckt satcheck(get_message_handler());
   bv_pointerst bv_pointers(ns, satcheck, get_message_handler());
 
-  if(!state.check_assertion(bv_pointers))
+  const bool success=state.check_assertion(bv_pointers);
+
+  number_of_solver_variables+=satcheck.no_variables();
+  number_of_solver_clauses+=satcheck.no_clauses();
+
+  if(!success)
   {
     property_entry.error_trace=build_goto_trace(state, bv_pointers);
 
@@ -420,6 +827,9 @@ bool path_searcht::is_feasible(const statet &state)
 
   bool result=state.is_feasible(bv_pointers);
 
+  number_of_solver_variables+=satcheck.no_variables();
+  number_of_solver_clauses+=satcheck.no_clauses();
+
   solver_time+=std::chrono::steady_clock::now()-solver_start_time;
 
   return result;
@@ -13,6 +13,7 @@ Author: Daniel Kroening, kroening@kroening.com
 #define CPROVER_SYMEX_PATH_SEARCH_H
 
 #include <chrono>
+#include <unordered_map>
 
 #include <util/expanding_vector.h>
 
@@ -20,7 +21,10 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <path-symex/path_symex_state.h>
 
+#include <goto-locs/property_reachability.h>
+
 #include <limits>
+#include <memory>
 
 class path_searcht:public safety_checkert
 {
@@ -31,6 +35,13 @@ public:
     eager_infeasibility(false),
     stop_on_fail(false),
     unwinding_assertions(false),
+    points_to_analysis(false),
+    fused_read(false),
+    time_reads(false),
+    loop_acceleration(false),
+    merge_states(false),
+    function_summaries(false),
+    drop_duplicate_states(false),
     number_of_dropped_states(0),
     number_of_paths(0),
     number_of_steps(0),
@@ -40,11 +51,23 @@ public:
     number_of_VCCs_after_simplification(0),
     number_of_failed_properties(0),
     number_of_locs(0),
+    number_of_memory_dropped_states(0),
+    number_of_merged_states(0),
+    number_of_duplicate_states(0),
+    number_of_unreaching_states(0),
+    number_of_solver_variables(0),
+    number_of_solver_clauses(0),
+    peak_memory(0),
+    last_memory(0),
+    reachability_failed_properties(0),
     depth_limit(std::numeric_limits<unsigned>::max()),
     context_bound(std::numeric_limits<unsigned>::max()),
     branch_bound(std::numeric_limits<unsigned>::max()),
     unwind_limit(std::numeric_limits<unsigned>::max()),
     time_limit(std::numeric_limits<unsigned>::max()),
+    memory_limit(std::numeric_limits<std::size_t>::max()),
+    max_array_expansion(std::numeric_limits<std::size_t>::max()),
+    propagation(propagationt::SIMPLE),
     search_heuristic(search_heuristict::DFS)
   {
   }
@@ -72,15 +95,42 @@ public:
     unwind_limit=limit;
   }
 
+  // comma-separated list of id:bound, where the id is
+  // a loop id or the identifier of a recursive function
+  void set_unwindset(const std::string &);
+
   void set_time_limit(int limit)
   {
     time_limit=limit;
   }
 
+  // in MiB
+  void set_memory_limit(std::size_t limit)
+  {
+    memory_limit=limit*1024*1024;
+  }
+
+  void set_max_array_expansion(std::size_t limit)
+  {
+    max_array_expansion=limit;
+  }
+
+  void set_propagation(propagationt _propagation)
+  {
+    propagation=_propagation;
+  }
+
   bool show_vcc;
   bool eager_infeasibility;
   bool stop_on_fail;
   bool unwinding_assertions;
+  bool points_to_analysis;
+  bool fused_read;
+  bool time_reads;
+  bool loop_acceleration;
+  bool merge_states;
+  bool function_summaries;
+  bool drop_duplicate_states;
 
   // statistics
   std::size_t number_of_dropped_states;
@@ -92,6 +142,18 @@ public:
   std::size_t number_of_VCCs_after_simplification;
   std::size_t number_of_failed_properties;
   std::size_t number_of_locs;
+  std::size_t number_of_memory_dropped_states;
+  std::size_t number_of_merged_states;
+  std::size_t number_of_duplicate_states;
+  std::size_t number_of_unreaching_states;
+
+  // size of the formulas, summed over all solver calls
+  std::size_t number_of_solver_variables;
+  std::size_t number_of_solver_clauses;
+
+  // approximate memory use in bytes
+  std::size_t peak_memory;
+  std::size_t last_memory;
 
   std::chrono::time_point<std::chrono::steady_clock> start_time;
   std::chrono::duration<double> solver_time;
@@ -125,11 +187,36 @@ public:
 protected:
   typedef path_symex_statet statet;
 
+  // indexed by loct::property_index
+  std::vector<property_entryt *> property_entries;
+
   // State queue. Iterators are stable.
   // The states most recently executed are at the head.
   typedef std::list<statet> queuet;
   queuet queue;
 
+  // States that wait at join points for others to merge with,
+  // used with merge_states.
+  queuet held;
+
+  // indexed by loc_reft::loc_number, the immediate
+  // post-dominators of the branches
+  std::vector<bool> merge_points;
+
+  // indexed by loc_reft::loc_number, the targets of the branches,
+  // where paths may meet again, used with drop_duplicate_states
+  std::vector<bool> join_points;
+
+  // the states seen at the join points, by fingerprint
+  typedef std::unordered_multimap<std::size_t, statet> visited_statest;
+  visited_statest visited_states;
+
+  // the locations that may reach a property that has not failed,
+  // updated when number_of_failed_properties changes; null with
+  // unwinding_assertions, which fail anywhere
+  std::unique_ptr<property_reachabilityt> property_reachability;
+  std::size_t reachability_failed_properties;
+
   // search heuristic
   void pick_state();
 
@@ -139,21 +226,44 @@ protected:
     loc_datat():visited(false) { }
   };
 
-  std::map<loc_reft, loc_datat> loc_data;
+  // indexed by loc_reft::loc_number
+  std::vector<loc_datat> loc_data;
 
   bool execute(queuet::iterator state);
+  bool merge(const statet &);
   void check_assertion(statet &);
   bool is_feasible(const statet &);
   void do_show_vcc(statet &);
   bool drop_state(const statet &);
-  void report_statistics();
+  bool is_duplicate(const statet &);
+  bool has_less_room(const statet &, const statet &) const;
+  bool may_reach_open_property(const statet &);
+  void report_statistics(const path_symex_configt &);
+  std::size_t approx_memory(const path_symex_configt &) const;
+  void check_memory(path_symex_configt &);
   void initialize_property_map(const goto_functionst &);
 
   unsigned depth_limit;
   unsigned context_bound;
   unsigned branch_bound;
   unsigned unwind_limit;
+
+  // bounds from --unwindset, by loop id or function identifier
+  std::map<irep_idt, unsigned> unwindset;
+
+  // indexed by loct::loop_index
+  std::vector<unsigned> loop_bounds;
+
+  unsigned get_recursion_bound(const irep_idt &function) const
+  {
+    const auto it=unwindset.find(function);
+    return it==unwindset.end()?unwind_limit:it->second;
+  }
+
   unsigned time_limit;
+  std::size_t memory_limit;
+  std::size_t max_array_expansion;
+  propagationt propagation;
 
   enum class search_heuristict { DFS, BFS, LOCS } search_heuristic;
 
@@ -40,7 +40,7 @@ void path_searcht::do_show_vcc(statet &state)
        !step_ref->ssa_guard.is_true())
     {
       out << faint << "{-" << count << "} " << reset
-          << format(step_ref->ssa_guard) << '\n';
+          << format(name_ssa_symbols(step_ref->ssa_guard)) << '\n';
       count++;
     }
 
@@ -48,7 +48,7 @@ void path_searcht::do_show_vcc(statet &state)
     {
       equal_exprt equality(step_ref->ssa_lhs, step_ref->ssa_rhs);
       out << faint << "{-" << count << "} " << reset
-          << format(equality) << '\n';
+          << format(name_ssa_symbols(equality)) << '\n';
       count++;
     }
   }
@@ -69,7 +69,7 @@ void path_searcht::do_show_vcc(statet &state)
   for(const auto &d : disjuncts)
   {
     out << faint << "{" << count << "} " << reset
-        << format(d) << '\n';
+        << format(name_ssa_symbols(d)) << '\n';
     count++;
   }
 
@@ -224,6 +224,9 @@ int symex_parse_optionst::doit()
       path_search.set_unwind_limit(
         unsafe_string2unsigned(cmdline.get_value("unwind")));
 
+    if(cmdline.isset("unwindset"))
+      path_search.set_unwindset(cmdline.get_value("unwindset"));
+
     path_search.set_unwinding_assertions(
       cmdline.isset("unwinding-assertions"));
 
@@ -231,6 +234,52 @@ int symex_parse_optionst::doit()
       path_search.set_time_limit(
         safe_string2unsigned(cmdline.get_value("max-search-time")));
 
+    if(cmdline.isset("max-memory"))
+      path_search.set_memory_limit(
+        safe_string2unsigned(cmdline.get_value("max-memory")));
+
+    if(cmdline.isset("max-array-expansion"))
+      path_search.set_max_array_expansion(
+        safe_string2unsigned(cmdline.get_value("max-array-expansion")));
+
+    path_search.points_to_analysis=
+      cmdline.isset("points-to-analysis");
+
+    path_search.fused_read=
+      cmdline.isset("fused-read");
+
+    path_search.time_reads=
+      cmdline.isset("time-reads");
+
+    path_search.loop_acceleration=
+      cmdline.isset("loop-acceleration");
+
+    path_search.merge_states=
+      cmdline.isset("merge-states");
+
+    path_search.function_summaries=
+      cmdline.isset("function-summaries");
+
+    path_search.drop_duplicate_states=
+      cmdline.isset("drop-duplicate-states");
+
+    if(cmdline.isset("no-propagation"))
+      path_search.set_propagation(propagationt::NONE);
+
+    if(cmdline.isset("propagation"))
+    {
+      const std::string propagation=cmdline.get_value("propagation");
+
+      if(propagation=="none")
+        path_search.set_propagation(propagationt::NONE);
+      else if(propagation=="simple")
+        path_search.set_propagation(propagationt::SIMPLE);
+      else if(propagation=="aggressive")
+        path_search.set_propagation(propagationt::AGGRESSIVE);
+      else
+        throw "--propagation expects none, simple or aggressive";
+    }
+
     if(cmdline.isset("dfs"))
       path_search.set_dfs();
 
@@ -652,10 +701,22 @@ void symex_parse_optionst::help()
     "\n"
     "Symex options:\n"
     " --unwind nr                  unwind nr times\n"
+    " --unwindset L:B,...          unwind loop or recursive function L with a bound of B\n" // NOLINT(*)
     " --depth nr                   limit search depth\n"
     " --context-bound nr           limit number of context switches\n"
     " --branch-bound nr            limit number of branches taken\n"
     " --max-search-time s          limit search to approximately s seconds\n"
+    " --max-memory MiB             drop states when the approximate memory use exceeds MiB\n" // NOLINT(*)
+    " --max-array-expansion n      keep arrays with more than n elements as a whole\n" // NOLINT(*)
+    " --propagation p              propagate none, simple (default) or aggressive\n" // NOLINT(*)
+    " --no-propagation             same as --propagation none\n"
+    " --loop-acceleration          execute simple counting loops at once\n" // NOLINT(*)
+    " --merge-states               merge states at the join points of branches\n" // NOLINT(*)
+    " --function-summaries         replay calls that only depend on concrete values\n" // NOLINT(*)
+    " --drop-duplicate-states      drop states seen before on another path\n" // NOLINT(*)
+    " --fused-read                 instantiate and simplify reads in a single pass\n" // NOLINT(*)
+    " --time-reads                 report the time spent in reads\n"
+    " --points-to-analysis         resolve pointers that are not propagated using a points-to analysis\n" // NOLINT(*)
     " --dfs                        use depth first search\n"
     " --bfs                        use breadth first search\n"
     " --eager-infeasibility        query solver early to determine whether a path is infeasible before searching it\n" // NOLINT(*)
@@ -31,6 +31,11 @@ class optionst;
   OPT_FUNCTIONS \
   "D:I:" \
   "(depth):(context-bound):(branch-bound):(unwind):(max-search-time):" \
+  "(unwindset):" \
+  "(max-memory):(max-array-expansion):(points-to-analysis)" \
+  "(propagation):(fused-read)(time-reads)" \
+  "(loop-acceleration)(merge-states)(function-summaries)" \
+  "(drop-duplicate-states)" \
   OPT_GOTO_CHECK \
   "(no-assertions)(no-assumptions)" \
   "(unwinding-assertions)" \